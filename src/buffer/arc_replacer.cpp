@@ -0,0 +1,179 @@
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+ARCReplacer::ARCReplacer(size_t num_pages, uint64_t correlated_period)
+    : capacity_(std::max<size_t>(1, num_pages)), correlated_period_(correlated_period), frames_(num_pages) {}
+
+ARCReplacer::~ARCReplacer() = default;
+
+void ARCReplacer::Admit(frame_id_t frame_id, List list) {
+  FrameInfo &frame = frames_[frame_id];
+  frame.list_ = list;
+  frame.key_ = ++current_tick_;
+  (list == List::kT1 ? t1_size_ : t2_size_)++;
+}
+
+void ARCReplacer::MakeUnevictable(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    (frame.list_ == List::kT1 ? t1_ : t2_).erase(make_pair(frame.key_, frame_id));
+    frame.evictable_ = false;
+  }
+}
+
+set<pair<uint64_t, frame_id_t>> *ARCReplacer::VictimList() {
+  if (!t1_.empty() && (t1_size_ > target_ || t2_.empty())) {
+    return &t1_;
+  }
+  if (!t2_.empty()) {
+    return &t2_;
+  }
+  return t1_.empty() ? nullptr : &t1_;
+}
+
+void ARCReplacer::Remember(GhostList &ghosts, page_tag_t page_tag) {
+  ghosts.order_.push_front(page_tag);
+  ghosts.map_[page_tag] = ghosts.order_.begin();
+}
+
+void ARCReplacer::Forget(GhostList &ghosts) {
+  ghosts.map_.erase(ghosts.order_.back());
+  ghosts.order_.pop_back();
+}
+
+void ARCReplacer::TrimGhosts() {
+  while (!b1_.order_.empty() && t1_size_ + b1_.order_.size() > capacity_) {
+    Forget(b1_);
+  }
+  while (t1_size_ + t2_size_ + b1_.order_.size() + b2_.order_.size() > 2 * capacity_) {
+    if (!b2_.order_.empty()) {
+      Forget(b2_);
+    } else if (!b1_.order_.empty()) {
+      Forget(b1_);
+    } else {
+      break;
+    }
+  }
+}
+
+void ARCReplacer::Evict(frame_id_t frame_id) {
+  MakeUnevictable(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.list_ == List::kT1) {
+    t1_size_--;
+  } else if (frame.list_ == List::kT2) {
+    t2_size_--;
+  }
+  if (frame.page_tag_ != INVALID_PAGE_ID && frame.list_ != List::kNone) {
+    Remember(frame.list_ == List::kT1 ? b1_ : b2_, frame.page_tag_);
+    TrimGhosts();
+  }
+  frame = FrameInfo();
+}
+
+bool ARCReplacer::Victim(frame_id_t *frame_id) {
+  auto *victims = VictimList();
+  if (victims == nullptr) {
+    return false;
+  }
+  *frame_id = victims->begin()->second;
+  Evict(*frame_id);
+  return true;
+}
+
+bool ARCReplacer::PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) {
+  auto *victims = VictimList();
+  if (victims == nullptr) {
+    return false;
+  }
+  int depth = 0;
+  for (auto it = victims->begin(); it != victims->end() && depth < VICTIM_SEARCH_DEPTH; ++it, ++depth) {
+    if (prefer(it->second)) {
+      *frame_id = it->second;
+      Evict(*frame_id);
+      return true;
+    }
+  }
+  return Victim(frame_id);
+}
+
+void ARCReplacer::Pin(frame_id_t frame_id) {
+  ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Invalid frame id.");
+  MakeUnevictable(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.list_ == List::kNone) {
+    Admit(frame_id, List::kT1);
+  } else if (frame.referenced_ && frame.list_ == List::kT1 && current_tick_ - frame.key_ > correlated_period_) {
+    // referenced again, well after the reference that read it: the page has proven it is reused
+    t1_size_--;
+    Admit(frame_id, List::kT2);
+  } else {
+    frame.key_ = ++current_tick_;
+  }
+  frame.referenced_ = true;
+}
+
+void ARCReplacer::Unpin(frame_id_t frame_id) {
+  ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Invalid frame id.");
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    return;
+  }
+  if (frame.list_ == List::kNone) {
+    Admit(frame_id, List::kT1);
+  }
+  (frame.list_ == List::kT1 ? t1_ : t2_).emplace(frame.key_, frame_id);
+  frame.evictable_ = true;
+}
+
+size_t ARCReplacer::Size() {
+  return t1_.size() + t2_.size();
+}
+
+void ARCReplacer::SetFramePage(frame_id_t frame_id, page_tag_t page_tag) {
+  ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Invalid frame id.");
+  MakeUnevictable(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.list_ == List::kT1) {
+    t1_size_--;
+  } else if (frame.list_ == List::kT2) {
+    t2_size_--;
+  }
+  frame = FrameInfo();
+  frame.page_tag_ = page_tag;
+  if (page_tag == INVALID_PAGE_ID) {
+    return;
+  }
+  // a ghost hit moves the target towards the list that lost the page
+  size_t b1_size = b1_.order_.size();
+  size_t b2_size = b2_.order_.size();
+  auto it = b1_.map_.find(page_tag);
+  if (it != b1_.map_.end()) {
+    target_ = std::min(capacity_, target_ + std::max<size_t>(1, b2_size / b1_size));
+    b1_.order_.erase(it->second);
+    b1_.map_.erase(it);
+    Admit(frame_id, List::kT2);
+    return;
+  }
+  it = b2_.map_.find(page_tag);
+  if (it != b2_.map_.end()) {
+    size_t step = std::max<size_t>(1, b1_size / b2_size);
+    target_ = target_ > step ? target_ - step : 0;
+    b2_.order_.erase(it->second);
+    b2_.map_.erase(it);
+    Admit(frame_id, List::kT2);
+    return;
+  }
+  Admit(frame_id, List::kT1);
+  TrimGhosts();
+}
+
+void ARCReplacer::Resize(size_t num_pages) {
+  frames_.resize(num_pages);
+  capacity_ = std::max<size_t>(1, num_pages);
+  target_ = std::min(target_, capacity_);
+  TrimGhosts();
+}
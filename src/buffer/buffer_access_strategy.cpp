@@ -0,0 +1,24 @@
+#include "buffer/buffer_access_strategy.h"
+
+#include <algorithm>
+
+#include "buffer/buffer_pool_manager.h"
+
+BufferAccessStrategy::BufferAccessStrategy(BufferPoolManager *buffer_pool_manager, size_t ring_size)
+    : buffer_pool_(buffer_pool_manager->GetBufferPool()) {
+  size_t num_shards = buffer_pool_->GetNumShards();
+  // two frames per shard at least, so the page just read is not recycled by the next one, and half of the frames
+  // at most, so a ring frame that is still pinned can always be replaced by one of the replacer
+  size_t shard_ring_size = std::min(ring_size / num_shards, buffer_pool_->GetPoolSize() / num_shards / 2);
+  shard_ring_size = std::max<size_t>(2, shard_ring_size);
+  rings_.assign(num_shards, vector<frame_id_t>(shard_ring_size, INVALID_FRAME_ID));
+  next_.assign(num_shards, 0);
+}
+
+size_t BufferAccessStrategy::GetRingSize() const {
+  return rings_.size() * rings_[0].size();
+}
+
+BufferAccessStrategy::~BufferAccessStrategy() {
+  buffer_pool_->ReleaseAccessStrategy(this);
+}
@@ -0,0 +1,812 @@
+#include "buffer/buffer_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "glog/logging.h"
+
+BufferPool::Shard::Shard(size_t index, size_t size, size_t max_size, ReplacerType replacer_type)
+    : index_(index),
+      arena_(max_size),
+      size_(size),
+      page_table_(size),
+      replacer_(Replacer::Create(replacer_type, size)),
+      ring_owner_(size, nullptr) {
+  for (size_t i = 0; i < size_; i++) {
+    pages_.emplace_back(arena_.GetFrame(i));
+    free_list_.emplace_back(i);
+  }
+}
+
+BufferPool::BufferPool(size_t pool_size, ReplacerType replacer_type, size_t num_shards)
+    : pool_size_(pool_size),
+      max_pool_size_(std::max<size_t>(pool_size, BUFFER_POOL_MAX_SIZE)),
+      files_(BUFFER_POOL_MAX_FILES, nullptr) {
+  if (num_shards == 0) {
+    // small pools stay in one piece, splitting them would only make NewPage fail earlier
+    num_shards = 1;
+    if (pool_size_ >= 2 * BUFFER_POOL_SHARD_MIN_FRAMES) {
+      num_shards = std::min<size_t>(BUFFER_POOL_MAX_SHARDS, pool_size_ / BUFFER_POOL_SHARD_MIN_FRAMES);
+    }
+  }
+  ASSERT(num_shards <= pool_size_, "Every shard needs at least one frame.");
+  // every shard gets the same share of the current and of the largest pool, so a resize never moves a frame
+  for (size_t i = 0; i < num_shards; i++) {
+    size_t size = pool_size_ / num_shards + (i < pool_size_ % num_shards ? 1 : 0);
+    size_t max_size = max_pool_size_ / num_shards + (i < max_pool_size_ % num_shards ? 1 : 0);
+    shards_.emplace_back(new Shard(i, size, max_size, replacer_type));
+  }
+}
+
+BufferPool::~BufferPool() {
+  {
+    lock_guard<mutex> guard(prefetch_latch_);
+    prefetch_stop_ = true;
+  }
+  prefetch_cv_.notify_all();
+  for (auto &io_thread : io_threads_) {
+    io_thread.join();
+  }
+  StopFlusher();
+  // files are detached by their handles, this only covers one that was not
+  for (auto &shard : shards_) {
+    for (Page &page : shard->pages_) {
+      if (page.page_id_ != INVALID_PAGE_ID && page.IsDirty() && files_[page.file_id_] != nullptr) {
+        files_[page.file_id_]->WritePage(page.page_id_, page.GetData());
+      }
+    }
+  }
+}
+
+file_id_t BufferPool::AttachFile(DiskManager *disk_manager) {
+  lock_guard<mutex> guard(files_latch_);
+  auto it = std::find(files_.begin(), files_.end(), nullptr);
+  ASSERT(it != files_.end(), "Too many files attached to the buffer pool.");
+  *it = disk_manager;
+  return static_cast<file_id_t>(it - files_.begin());
+}
+
+void BufferPool::DetachFile(file_id_t file_id) {
+  CancelPrefetches([file_id](const PrefetchRequest &request) { return request.file_id_ == file_id; });
+  for (auto &shard : shards_) {
+    unique_lock<mutex> lock(shard->latch_);
+    // writes in flight use the disk manager of the file, they are done before it goes away
+    shard->io_cv_.wait(lock, [&shard, file_id] {
+      return std::none_of(shard->writing_.begin(), shard->writing_.end(), [file_id](const pair<page_tag_t, int> &w) {
+        return static_cast<file_id_t>(w.first >> 32) == file_id;
+      });
+    });
+    shard->compressed_.EraseFile(file_id);
+    for (size_t i = 0; i < shard->size_; i++) {
+      auto frame_id = static_cast<frame_id_t>(i);
+      Page &page = shard->pages_[frame_id];
+      if (page.page_id_ == INVALID_PAGE_ID || page.file_id_ != file_id) {
+        continue;
+      }
+      if (page.IsDirty()) {
+        files_[file_id]->WritePage(page.page_id_, page.GetData());
+        CountersOf(*shard, page).write_backs_++;
+      }
+      DropPage(*shard, frame_id);
+      page.page_id_ = INVALID_PAGE_ID;
+      page.pin_count_ = 0;
+      page.is_dirty_ = false;
+      shard->free_list_.push_back(frame_id);
+    }
+  }
+  lock_guard<mutex> guard(files_latch_);
+  files_[file_id] = nullptr;
+}
+
+void BufferPool::ReadPage(Shard &shard, file_id_t file_id, page_id_t page_id, char *data) {
+  if (shard.compressed_.Take(TagOf(file_id, page_id), data)) {
+    shard.compressed_hits_++;
+    return;
+  }
+  files_[file_id]->ReadPage(page_id, data);
+}
+
+frame_id_t BufferPool::TryToFindFreePage(Shard &shard, unique_lock<mutex> &lock) {
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  // pages are always found from the free list first
+  if (!shard.free_list_.empty()) {
+    frame_id = shard.free_list_.front();
+    shard.free_list_.pop_front();
+    return frame_id;
+  }
+  // a clean victim costs no write, the background writer keeps most cold frames clean
+  auto is_clean = [&shard](frame_id_t candidate) { return !shard.pages_[candidate].IsDirty(); };
+  if (!shard.replacer_->PreferredVictim(&frame_id, is_clean)) {
+    return INVALID_FRAME_ID;
+  }
+  Page &victim = shard.pages_[frame_id];
+  shard.page_table_.Erase(TagOf(victim));
+  CountersOf(shard, victim).evictions_++;
+  if (victim.IsDirty()) {
+    CountersOf(shard, victim).dirty_evictions_++;
+    WakeFlusher();
+    WriteBack(shard, lock, victim);
+    victim.is_dirty_ = false;
+  }
+  // the page is clean now, keep it compressed unless the cache is off; recycled ring pages are not worth it
+  shard.compressed_.Insert(TagOf(victim), victim.GetData());
+  return frame_id;
+}
+
+frame_id_t BufferPool::TryToFindRingPage(Shard &shard, unique_lock<mutex> &lock, BufferAccessStrategy &strategy) {
+  vector<frame_id_t> &ring = strategy.rings_[shard.index_];
+  size_t &next = strategy.next_[shard.index_];
+  frame_id_t frame_id = ring[next];
+  // the slot may still name a frame the shard dropped when it was shrunk
+  if (frame_id != INVALID_FRAME_ID && static_cast<size_t>(frame_id) < shard.size_ &&
+      shard.ring_owner_[frame_id] == &strategy) {
+    Page &recycled = shard.pages_[frame_id];
+    if (recycled.pin_count_ == 0) {
+      // recycle the page this slot got a lap ago
+      shard.page_table_.Erase(TagOf(recycled));
+      next = (next + 1) % ring.size();
+      CountersOf(shard, recycled).evictions_++;
+      if (recycled.IsDirty()) {
+        CountersOf(shard, recycled).dirty_evictions_++;
+        WriteBack(shard, lock, recycled);
+        recycled.is_dirty_ = false;
+      }
+      return frame_id;
+    }
+    // someone else still uses the page, leave the frame to the pool and take a new one
+    shard.ring_owner_[frame_id] = nullptr;
+    shard.replacer_->SetFramePage(frame_id, TagOf(recycled));
+    shard.replacer_->Pin(frame_id);
+  }
+  frame_id = TryToFindFreePage(shard, lock);
+  if (frame_id == INVALID_FRAME_ID) {
+    return INVALID_FRAME_ID;
+  }
+  shard.ring_owner_[frame_id] = &strategy;
+  ring[next] = frame_id;
+  next = (next + 1) % ring.size();
+  return frame_id;
+}
+
+void BufferPool::WriteBack(Shard &shard, unique_lock<mutex> &lock, const Page &page) {
+  // claim the page before waiting, so nobody reads it from disk until this write is done
+  page_tag_t page_tag = TagOf(page);
+  shard.writing_[page_tag]++;
+  shard.io_cv_.wait(lock, [&shard, page_tag] { return shard.writing_[page_tag] == 1; });
+  files_[page.file_id_]->WritePage(page.page_id_, page.data_);
+  CountersOf(shard, page).write_backs_++;
+  if (--shard.writing_[page_tag] == 0) {
+    shard.writing_.erase(page_tag);
+  }
+  shard.io_cv_.notify_all();
+}
+
+bool BufferPool::Resize(size_t pool_size) {
+  lock_guard<mutex> guard(resize_latch_);
+  if (pool_size < shards_.size() || pool_size > max_pool_size_) {
+    LOG(WARNING) << "Buffer pool size must be between " << shards_.size() << " and " << max_pool_size_ << "."
+                 << std::endl;
+    return false;
+  }
+  bool resized = true;
+  for (size_t i = 0; i < shards_.size(); i++) {
+    Shard &shard = *shards_[i];
+    size_t size = pool_size / shards_.size() + (i < pool_size % shards_.size() ? 1 : 0);
+    if (size > shard.size_) {
+      lock_guard<mutex> shard_guard(shard.latch_);
+      GrowShard(shard, size);
+    } else if (size < shard.size_) {
+      resized &= ShrinkShard(shard, size);
+    }
+  }
+  return resized;
+}
+
+void BufferPool::GrowShard(Shard &shard, size_t size) {
+  for (size_t frame_id = shard.size_; frame_id < size; frame_id++) {
+    shard.pages_.emplace_back(shard.arena_.GetFrame(frame_id));
+    shard.free_list_.push_back(frame_id);
+  }
+  shard.ring_owner_.resize(size, nullptr);
+  shard.replacer_->Resize(size);
+  shard.page_table_.Resize(size);
+  pool_size_ += size - shard.size_;
+  shard.size_ = size;
+}
+
+void BufferPool::SetCompressedCacheSize(size_t size) {
+  for (size_t i = 0; i < shards_.size(); i++) {
+    lock_guard<mutex> guard(shards_[i]->latch_);
+    shards_[i]->compressed_.SetCapacity(size / shards_.size() + (i < size % shards_.size() ? 1 : 0));
+  }
+  compressed_cache_size_ = size;
+}
+
+bool BufferPool::ShrinkShard(Shard &shard, size_t size) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(POOL_RESIZE_TIMEOUT_MS);
+  unique_lock<mutex> lock(shard.latch_);
+  while (!EvictTail(shard, lock, size)) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      LOG(WARNING) << "Buffer pool shard " << shard.index_ << " still has pinned pages, not shrunk." << std::endl;
+      return false;
+    }
+    // give the holders of the pinned pages the latch to unpin them
+    lock.unlock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    lock.lock();
+  }
+  // the frames past size are empty and known to nobody, the latch was held since EvictTail made sure of it
+  shard.page_table_.Resize(size);
+  shard.replacer_->Resize(size);
+  shard.ring_owner_.resize(size);
+  while (shard.pages_.size() > size) {
+    shard.pages_.pop_back();
+  }
+  shard.arena_.Release(size, shard.size_ - size);
+  if (shard.flush_hand_ >= size) {
+    shard.flush_hand_ = 0;
+  }
+  pool_size_ -= shard.size_ - size;
+  shard.size_ = size;
+  return true;
+}
+
+bool BufferPool::EvictTail(Shard &shard, unique_lock<mutex> &lock, size_t size) {
+  bool empty = true;
+  for (size_t i = size; i < shard.size_; i++) {
+    auto frame_id = static_cast<frame_id_t>(i);
+    Page &page = shard.pages_[frame_id];
+    if (page.page_id_ == INVALID_PAGE_ID) {
+      continue;
+    }
+    // a frame whose page is not in the page table is being handed to another page by an eviction in flight
+    frame_id_t resident;
+    if (page.pin_count_ != 0 || !shard.page_table_.Find(TagOf(page), &resident) || resident != frame_id) {
+      empty = false;
+      continue;
+    }
+    DropPage(shard, frame_id);
+    CountersOf(shard, page).evictions_++;
+    if (page.IsDirty()) {
+      CountersOf(shard, page).dirty_evictions_++;
+      WriteBack(shard, lock, page);
+      page.is_dirty_ = false;
+    }
+    shard.compressed_.Insert(TagOf(page), page.GetData());
+    page.page_id_ = INVALID_PAGE_ID;
+  }
+  // frames past size may have been freed while the latch was released for a write
+  shard.free_list_.remove_if([size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= size; });
+  return empty;
+}
+
+void BufferPool::DropPage(Shard &shard, frame_id_t frame_id) {
+  shard.page_table_.Erase(TagOf(shard.pages_[frame_id]));
+  if (shard.ring_owner_[frame_id] == nullptr) {
+    shard.replacer_->Pin(frame_id);
+    shard.replacer_->SetFramePage(frame_id, INVALID_PAGE_ID);
+  }
+  shard.ring_owner_[frame_id] = nullptr;
+}
+
+void BufferPool::ReturnFrame(Shard &shard, frame_id_t frame_id) {
+  shard.pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  shard.ring_owner_[frame_id] = nullptr;
+  shard.free_list_.push_back(frame_id);
+}
+
+Page *BufferPool::FetchPage(file_id_t file_id, page_id_t page_id, BufferAccessStrategy *strategy) {
+  Trace(PageTraceOp::kFetch, file_id, page_id);
+  return PinOrReadPage(file_id, page_id, strategy);
+}
+
+Page *BufferPool::PinOrReadPage(file_id_t file_id, page_id_t page_id, BufferAccessStrategy *strategy) {
+  Shard &shard = ShardOf(file_id, page_id);
+  page_tag_t page_tag = TagOf(file_id, page_id);
+  unique_lock<mutex> lock(shard.latch_);
+  // 1.     Search the page table for the requested page (P).
+  //        A page that is being written is not read back before the write is done.
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  int waits = 0;
+  while (!shard.page_table_.Find(page_tag, &frame_id) && shard.writing_.count(page_tag) != 0) {
+    shard.io_cv_.wait(lock);
+    waits++;
+  }
+  if (frame_id != INVALID_FRAME_ID) {
+    // 1.1    If P exists, pin it and return it immediately.
+    Page &page = shard.pages_[frame_id];
+    CountersOf(shard, page).hits_++;
+    CountersOf(shard, page).pin_waits_ += waits;
+    page.pin_count_++;
+    if (shard.ring_owner_[frame_id] == nullptr) {
+      shard.replacer_->Pin(frame_id);
+    }
+    return &page;
+  }
+  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer,
+  //        or from the ring of the strategy if there is one.
+  // 2.     If R is dirty, write it back to the disk.
+  frame_id = strategy == nullptr ? TryToFindFreePage(shard, lock) : TryToFindRingPage(shard, lock, *strategy);
+  if (frame_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+  frame_id_t resident;
+  if (shard.page_table_.Find(page_tag, &resident) || shard.writing_.count(page_tag) != 0) {
+    // P was read or written by someone else while R was written back, give R back and start over
+    ReturnFrame(shard, frame_id);
+    lock.unlock();
+    return PinOrReadPage(file_id, page_id, strategy);
+  }
+  // 3.     Delete R from the page table and insert P.
+  shard.page_table_.Insert(page_tag, frame_id);
+  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+  Page &page = shard.pages_[frame_id];
+  page.page_id_ = page_id;
+  page.file_id_ = file_id;
+  page.pin_count_ = 1;
+  page.is_dirty_ = false;
+  // the miss is counted when the page is unpinned, under the type its owner tags it with meanwhile
+  ResetPageType(page);
+  page.miss_pending_ = true;
+  page.waits_pending_ = waits;
+  ReadPage(shard, file_id, page_id, page.GetData());
+  if (shard.ring_owner_[frame_id] == nullptr) {
+    shard.replacer_->SetFramePage(frame_id, page_tag);
+    shard.replacer_->Pin(frame_id);
+  }
+  return &page;
+}
+
+void BufferPool::PrefetchPage(file_id_t file_id, page_id_t page_id, BufferAccessStrategy *strategy) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  lock_guard<mutex> guard(prefetch_latch_);
+  if (io_threads_.empty()) {
+    for (int i = 0; i < PREFETCH_IO_THREADS; i++) {
+      io_threads_.emplace_back(&BufferPool::PrefetchLoop, this);
+    }
+  }
+  if (prefetch_queue_.size() >= PREFETCH_QUEUE_SIZE) {
+    return;
+  }
+  prefetch_queue_.push_back({file_id, page_id, strategy});
+  prefetch_cv_.notify_one();
+}
+
+void BufferPool::DropPrefetch(file_id_t file_id, page_id_t page_id) {
+  lock_guard<mutex> guard(prefetch_latch_);
+  prefetch_queue_.erase(remove_if(prefetch_queue_.begin(), prefetch_queue_.end(),
+                                  [file_id, page_id](const PrefetchRequest &request) {
+                                    return request.file_id_ == file_id && request.page_id_ == page_id;
+                                  }),
+                        prefetch_queue_.end());
+}
+
+void BufferPool::PrefetchLoop() {
+  unique_lock<mutex> lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return prefetch_stop_ || !prefetch_queue_.empty(); });
+    if (prefetch_stop_) {
+      return;
+    }
+    auto serving = prefetch_serving_.insert(prefetch_serving_.end(), prefetch_queue_.front());
+    prefetch_queue_.pop_front();
+    lock.unlock();
+    ReadAhead(serving->file_id_, serving->page_id_, serving->strategy_);
+    lock.lock();
+    prefetch_serving_.erase(serving);
+    prefetch_cv_.notify_all();
+  }
+}
+
+template <typename Predicate>
+void BufferPool::CancelPrefetches(Predicate matches) {
+  unique_lock<mutex> lock(prefetch_latch_);
+  prefetch_queue_.erase(remove_if(prefetch_queue_.begin(), prefetch_queue_.end(), matches), prefetch_queue_.end());
+  prefetch_cv_.wait(lock, [this, &matches] {
+    return std::none_of(prefetch_serving_.begin(), prefetch_serving_.end(), matches);
+  });
+}
+
+void BufferPool::ReadAhead(file_id_t file_id, page_id_t page_id, BufferAccessStrategy *strategy) {
+  Shard &shard = ShardOf(file_id, page_id);
+  page_tag_t page_tag = TagOf(file_id, page_id);
+  unique_lock<mutex> lock(shard.latch_);
+  // a page being written was just evicted, reading it back would only race with the write
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  if (shard.page_table_.Find(page_tag, &frame_id) || shard.writing_.count(page_tag) != 0) {
+    return;
+  }
+  frame_id = strategy == nullptr ? TryToFindFreePage(shard, lock) : TryToFindRingPage(shard, lock, *strategy);
+  if (frame_id == INVALID_FRAME_ID) {
+    return;
+  }
+  frame_id_t resident;
+  if (shard.page_table_.Find(page_tag, &resident) || shard.writing_.count(page_tag) != 0) {
+    ReturnFrame(shard, frame_id);
+    return;
+  }
+  shard.page_table_.Insert(page_tag, frame_id);
+  Page &page = shard.pages_[frame_id];
+  page.page_id_ = page_id;
+  page.file_id_ = file_id;
+  page.pin_count_ = 0;
+  page.is_dirty_ = false;
+  ResetPageType(page);
+  ReadPage(shard, file_id, page_id, page.GetData());
+  shard.prefetch_count_++;
+  // the page enters the replacer unpinned, as if it had been fetched and released
+  if (shard.ring_owner_[frame_id] == nullptr) {
+    shard.replacer_->SetFramePage(frame_id, page_tag);
+    shard.replacer_->Unpin(frame_id);
+  }
+}
+
+bool BufferPool::PeekPage(file_id_t file_id, page_id_t page_id, char *data) {
+  Shard &shard = ShardOf(file_id, page_id);
+  lock_guard<mutex> guard(shard.latch_);
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  if (page_id == INVALID_PAGE_ID || !shard.page_table_.Find(TagOf(file_id, page_id), &frame_id)) {
+    return false;
+  }
+  memcpy(data, shard.pages_[frame_id].GetData(), PAGE_SIZE);
+  return true;
+}
+
+Page *BufferPool::NewPage(file_id_t file_id, page_id_t &page_id, ExtentAllocator *extents, uint32_t data_file) {
+  // 0.   Allocate the page first, it decides which shard the frame comes from.
+  DiskManager *disk_manager = files_[file_id];
+  page_id_t new_page_id =
+      extents == nullptr ? disk_manager->AllocatePage(data_file) : extents->AllocatePage(disk_manager);
+  if (new_page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  Shard &shard = ShardOf(file_id, new_page_id);
+  unique_lock<mutex> lock(shard.latch_);
+  // 1.   Pick a victim page P from either the free list or the replacer.
+  //      If all the pages of the shard are pinned, give the page back and return nullptr.
+  frame_id_t frame_id = TryToFindFreePage(shard, lock);
+  if (frame_id == INVALID_FRAME_ID) {
+    if (extents == nullptr) {
+      disk_manager->DeAllocatePage(new_page_id);
+    } else {
+      extents->DeAllocatePage(disk_manager, new_page_id);
+    }
+    return nullptr;
+  }
+  // 2.   Update P's metadata, zero out memory and add P to the page table.
+  //      A new page is dirty: the zeroed frame has to reach disk even if the caller never writes it.
+  page_tag_t page_tag = TagOf(file_id, new_page_id);
+  Page &page = shard.pages_[frame_id];
+  page.page_id_ = new_page_id;
+  page.file_id_ = file_id;
+  page.pin_count_ = 1;
+  page.is_dirty_ = true;
+  page.ResetMemory();
+  ResetPageType(page);
+  shard.page_table_.Insert(page_tag, frame_id);
+  shard.compressed_.Erase(page_tag);
+  shard.replacer_->SetFramePage(frame_id, page_tag);
+  shard.replacer_->Pin(frame_id);
+  // 3.   Set the page ID output parameter. Return a pointer to P.
+  page_id = new_page_id;
+  Trace(PageTraceOp::kNew, file_id, new_page_id);
+  return &page;
+}
+
+bool BufferPool::DeletePage(file_id_t file_id, page_id_t page_id) {
+  // a read-ahead still on its way would bring the old page back after it is allocated again
+  CancelPrefetches([file_id, page_id](const PrefetchRequest &request) {
+    return request.file_id_ == file_id && request.page_id_ == page_id;
+  });
+  Shard &shard = ShardOf(file_id, page_id);
+  lock_guard<mutex> guard(shard.latch_);
+  // 1.   Search the page table for the requested page (P).
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  if (shard.page_table_.Find(TagOf(file_id, page_id), &frame_id)) {
+    // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
+    Page &page = shard.pages_[frame_id];
+    if (page.pin_count_ != 0) {
+      return false;
+    }
+    // 3.   Otherwise, remove P from the page table, reset its metadata and return it to the free list.
+    DropPage(shard, frame_id);
+    page.ResetMemory();
+    page.page_id_ = INVALID_PAGE_ID;
+    page.pin_count_ = 0;
+    page.is_dirty_ = false;
+    shard.free_list_.push_back(frame_id);
+  }
+  // 4.   Give the page back to the disk manager whether it was resident or not.
+  shard.compressed_.Erase(TagOf(file_id, page_id));
+  files_[file_id]->DeAllocatePage(page_id);
+  return true;
+}
+
+bool BufferPool::UnpinPage(file_id_t file_id, page_id_t page_id, bool is_dirty) {
+  Trace(PageTraceOp::kUnpin, file_id, page_id);
+  Shard &shard = ShardOf(file_id, page_id);
+  lock_guard<mutex> guard(shard.latch_);
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  if (!shard.page_table_.Find(TagOf(file_id, page_id), &frame_id)) {
+    return true;
+  }
+  Page &page = shard.pages_[frame_id];
+  if (page.pin_count_ > 0) {
+    page.pin_count_--;
+  }
+  page.is_dirty_ |= is_dirty;
+  if (page.miss_pending_) {
+    CountersOf(shard, page).misses_++;
+    CountersOf(shard, page).pin_waits_ += page.waits_pending_;
+    page.miss_pending_ = false;
+    page.waits_pending_ = 0;
+  }
+  if (page.pin_count_ == 0 && shard.ring_owner_[frame_id] == nullptr) {
+    shard.replacer_->Unpin(frame_id);
+  }
+  return true;
+}
+
+bool BufferPool::FlushPage(file_id_t file_id, page_id_t page_id) {
+  Shard &shard = ShardOf(file_id, page_id);
+  page_tag_t page_tag = TagOf(file_id, page_id);
+  unique_lock<mutex> lock(shard.latch_);
+  // a write in flight may carry older data, this one has to land after it
+  shard.io_cv_.wait(lock, [&shard, page_tag] { return shard.writing_.count(page_tag) == 0; });
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  if (!shard.page_table_.Find(page_tag, &frame_id)) {
+    return false;
+  }
+  Page &page = shard.pages_[frame_id];
+  files_[file_id]->WritePage(page_id, page.GetData());
+  CountersOf(shard, page).write_backs_++;
+  page.is_dirty_ = false;
+  return true;
+}
+
+void BufferPool::StartFlusher(std::chrono::milliseconds interval) {
+  if (flusher_.joinable()) {
+    return;
+  }
+  flusher_stop_ = false;
+  flusher_ = thread(&BufferPool::FlusherLoop, this, interval);
+}
+
+void BufferPool::StopFlusher() {
+  if (!flusher_.joinable()) {
+    return;
+  }
+  {
+    lock_guard<mutex> guard(flusher_latch_);
+    flusher_stop_ = true;
+  }
+  flusher_cv_.notify_one();
+  flusher_.join();
+}
+
+bool BufferPool::StartTrace(const string &file_name) {
+  lock_guard<mutex> guard(trace_latch_);
+  auto trace = make_unique<PageTraceWriter>(file_name);
+  if (!trace->IsOpen()) {
+    return false;
+  }
+  PageTraceWriter *previous = trace_.exchange(trace.get(), std::memory_order_acq_rel);
+  if (previous != nullptr) {
+    previous->Close();
+  }
+  traces_.push_back(std::move(trace));
+  return true;
+}
+
+size_t BufferPool::StopTrace() {
+  lock_guard<mutex> guard(trace_latch_);
+  PageTraceWriter *trace = trace_.exchange(nullptr, std::memory_order_acq_rel);
+  if (trace == nullptr) {
+    return 0;
+  }
+  trace->Close();
+  return trace->GetRecordCount();
+}
+
+void BufferPool::WakeFlusher() {
+  {
+    lock_guard<mutex> guard(flusher_latch_);
+    flusher_wakeup_ = true;
+  }
+  flusher_cv_.notify_one();
+}
+
+void BufferPool::FlusherLoop(std::chrono::milliseconds interval) {
+  // aligned like the frames, so the copies can be written with direct I/O as well
+  FrameArena buffer(FLUSHER_BATCH_SIZE);
+  unique_lock<mutex> lock(flusher_latch_);
+  while (!flusher_stop_) {
+    lock.unlock();
+    bool busy = false;
+    for (auto &shard : shards_) {
+      busy |= FlushDirtyFrames(*shard, buffer.GetFrame(0), FLUSHER_BATCH_SIZE) == FLUSHER_BATCH_SIZE;
+    }
+    lock.lock();
+    // a shard with a full batch probably has more dirty frames, go on without sleeping
+    if (!busy) {
+      flusher_cv_.wait_for(lock, interval, [this] { return flusher_stop_ || flusher_wakeup_; });
+    }
+    flusher_wakeup_ = false;
+  }
+}
+
+size_t BufferPool::FlushDirtyFrames(Shard &shard, char *buffer, size_t max_pages) {
+  vector<page_tag_t> page_tags;
+  vector<pair<DiskManager *, page_id_t>> writes;
+  {
+    lock_guard<mutex> guard(shard.latch_);
+    for (size_t n = 0; n < shard.size_ && writes.size() < max_pages; n++) {
+      frame_id_t frame_id = shard.flush_hand_;
+      shard.flush_hand_ = (shard.flush_hand_ + 1) % shard.size_;
+      Page &page = shard.pages_[frame_id];
+      // an unpinned page cannot change, a copy of it is as good as the frame
+      frame_id_t resident;
+      if (page.page_id_ == INVALID_PAGE_ID || !page.IsDirty() || page.pin_count_ != 0 ||
+          !shard.page_table_.Find(TagOf(page), &resident) || resident != frame_id ||
+          shard.writing_.count(TagOf(page)) != 0) {
+        continue;
+      }
+      memcpy(buffer + writes.size() * PAGE_SIZE, page.GetData(), PAGE_SIZE);
+      page.is_dirty_ = false;
+      CountersOf(shard, page).write_backs_++;
+      shard.writing_[TagOf(page)]++;
+      page_tags.push_back(TagOf(page));
+      writes.emplace_back(files_[page.file_id_], page.page_id_);
+    }
+  }
+  if (writes.empty()) {
+    return 0;
+  }
+  // the whole batch goes out at once when the disk manager can keep several writes in flight
+  mutex done_latch;
+  condition_variable done_cv;
+  size_t pending = writes.size();
+  for (size_t i = 0; i < writes.size(); i++) {
+    writes[i].first->WritePageAsync(writes[i].second, buffer + i * PAGE_SIZE, [&done_latch, &done_cv, &pending] {
+      lock_guard<mutex> guard(done_latch);
+      if (--pending == 0) {
+        done_cv.notify_one();
+      }
+    });
+  }
+  {
+    unique_lock<mutex> lock(done_latch);
+    done_cv.wait(lock, [&pending] { return pending == 0; });
+  }
+  {
+    lock_guard<mutex> guard(shard.latch_);
+    for (page_tag_t page_tag : page_tags) {
+      if (--shard.writing_[page_tag] == 0) {
+        shard.writing_.erase(page_tag);
+      }
+    }
+  }
+  shard.io_cv_.notify_all();
+  return writes.size();
+}
+
+void BufferPool::ReleaseAccessStrategy(BufferAccessStrategy *strategy) {
+  // drop the read-ahead requests of the strategy and wait for the one being served
+  CancelPrefetches([strategy](const PrefetchRequest &request) { return request.strategy_ == strategy; });
+  for (auto &shard : shards_) {
+    lock_guard<mutex> guard(shard->latch_);
+    for (frame_id_t frame_id : strategy->rings_[shard->index_]) {
+      if (frame_id == INVALID_FRAME_ID || static_cast<size_t>(frame_id) >= shard->size_ ||
+          shard->ring_owner_[frame_id] != strategy) {
+        continue;
+      }
+      shard->ring_owner_[frame_id] = nullptr;
+      Page &page = shard->pages_[frame_id];
+      shard->replacer_->SetFramePage(frame_id, TagOf(page));
+      if (page.pin_count_ == 0) {
+        shard->replacer_->Unpin(frame_id);
+      } else {
+        shard->replacer_->Pin(frame_id);
+      }
+    }
+  }
+}
+
+PageTypeStats &PageTypeStats::operator+=(const PageTypeStats &other) {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  evictions_ += other.evictions_;
+  dirty_evictions_ += other.dirty_evictions_;
+  write_backs_ += other.write_backs_;
+  pin_waits_ += other.pin_waits_;
+  return *this;
+}
+
+PageTypeStats ShardStats::Total() const {
+  PageTypeStats total;
+  for (const auto &page_type : page_types_) {
+    total += page_type;
+  }
+  return total;
+}
+
+PageTypeStats BufferPoolStats::Total(PageType page_type) const {
+  PageTypeStats total;
+  for (const auto &shard : shards_) {
+    total += shard.page_types_[static_cast<size_t>(page_type)];
+  }
+  return total;
+}
+
+PageTypeStats BufferPoolStats::Total() const {
+  PageTypeStats total;
+  for (const auto &shard : shards_) {
+    total += shard.Total();
+  }
+  return total;
+}
+
+BufferPoolStats BufferPool::GetStats() {
+  BufferPoolStats stats;
+  stats.pool_size_ = pool_size_;
+  stats.max_pool_size_ = max_pool_size_;
+  stats.compressed_cache_size_ = compressed_cache_size_;
+  for (auto &shard : shards_) {
+    ShardStats shard_stats;
+    for (size_t i = 0; i < NUM_PAGE_TYPES; i++) {
+      const PageTypeCounters &counters = shard->counters_[i];
+      PageTypeStats &page_type = shard_stats.page_types_[i];
+      page_type.hits_ = counters.hits_.load(std::memory_order_relaxed);
+      page_type.misses_ = counters.misses_.load(std::memory_order_relaxed);
+      page_type.evictions_ = counters.evictions_.load(std::memory_order_relaxed);
+      page_type.dirty_evictions_ = counters.dirty_evictions_.load(std::memory_order_relaxed);
+      page_type.write_backs_ = counters.write_backs_.load(std::memory_order_relaxed);
+      page_type.pin_waits_ = counters.pin_waits_.load(std::memory_order_relaxed);
+    }
+    shard_stats.prefetches_ = shard->prefetch_count_.load(std::memory_order_relaxed);
+    shard_stats.compressed_hits_ = shard->compressed_hits_.load(std::memory_order_relaxed);
+    {
+      lock_guard<mutex> guard(shard->latch_);
+      shard_stats.frames_ = shard->size_;
+      shard_stats.free_frames_ = shard->free_list_.size();
+      shard_stats.replacer_size_ = shard->replacer_->Size();
+      shard_stats.compressed_pages_ = shard->compressed_.GetPageCount();
+      shard_stats.compressed_bytes_ = shard->compressed_.GetSize();
+    }
+    stats.shards_.push_back(shard_stats);
+  }
+  return stats;
+}
+
+size_t BufferPool::GetPrefetchCount() {
+  size_t prefetch_count = 0;
+  for (auto &shard : shards_) {
+    prefetch_count += shard->prefetch_count_.load(std::memory_order_relaxed);
+  }
+  return prefetch_count;
+}
+
+// Only used for debug
+bool BufferPool::IsResident(file_id_t file_id, page_id_t page_id) {
+  Shard &shard = ShardOf(file_id, page_id);
+  lock_guard<mutex> guard(shard.latch_);
+  frame_id_t frame_id;
+  return shard.page_table_.Find(TagOf(file_id, page_id), &frame_id);
+}
+
+// Only used for debug
+bool BufferPool::CheckAllUnpinned() {
+  bool res = true;
+  for (auto &shard : shards_) {
+    lock_guard<mutex> guard(shard->latch_);
+    for (size_t i = 0; i < shard->size_; i++) {
+      if (shard->pages_[i].pin_count_ != 0) {
+        res = false;
+        LOG(ERROR) << "page " << shard->pages_[i].page_id_ << " pin count:" << shard->pages_[i].pin_count_ << endl;
+      }
+    }
+  }
+  return res;
+}
@@ -0,0 +1,98 @@
+#include "buffer/clock_sweep_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+ClockSweepReplacer::ClockSweepReplacer(size_t num_pages)
+    : num_frames_(num_pages), states_(new atomic<uint32_t>[std::max<size_t>(1, num_pages)]) {
+  for (size_t i = 0; i < num_frames_; i++) {
+    states_[i].store(0);
+  }
+}
+
+ClockSweepReplacer::~ClockSweepReplacer() = default;
+
+bool ClockSweepReplacer::Sweep(frame_id_t *frame_id, const std::function<bool(frame_id_t)> *prefer, int skip_left) {
+  if (num_frames_ == 0) {
+    return false;
+  }
+  // enough steps to bring every usage count down to zero and pass all frames once more, the hand only runs out of
+  // them when other threads keep pinning the frames it meets
+  size_t steps = (CLOCK_SWEEP_MAX_USAGE + 2) * num_frames_ + skip_left;
+  for (size_t step = 0; step < steps && size_.load() > 0; step++) {
+    auto index = static_cast<frame_id_t>(hand_.fetch_add(1) % num_frames_);
+    atomic<uint32_t> &state = states_[index];
+    uint32_t current = state.load();
+    while ((current & EVICTABLE) != 0) {
+      if ((current & USAGE_MASK) > 0) {
+        if (state.compare_exchange_weak(current, current - 1)) {
+          break;
+        }
+      } else if (skip_left > 0 && !(*prefer)(index)) {
+        skip_left--;
+        break;
+      } else if (state.compare_exchange_weak(current, 0)) {
+        size_--;
+        *frame_id = index;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool ClockSweepReplacer::Victim(frame_id_t *frame_id) {
+  return Sweep(frame_id, nullptr, 0);
+}
+
+bool ClockSweepReplacer::PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) {
+  return Sweep(frame_id, &prefer, VICTIM_SEARCH_DEPTH);
+}
+
+void ClockSweepReplacer::Pin(frame_id_t frame_id) {
+  ASSERT(static_cast<size_t>(frame_id) < num_frames_, "Invalid frame id.");
+  atomic<uint32_t> &state = states_[frame_id];
+  uint32_t current = state.load();
+  uint32_t next;
+  do {
+    next = current & ~EVICTABLE;
+    if ((next & USAGE_MASK) < static_cast<uint32_t>(CLOCK_SWEEP_MAX_USAGE)) {
+      next++;
+    }
+  } while (!state.compare_exchange_weak(current, next));
+  if ((current & EVICTABLE) != 0) {
+    size_--;
+  }
+}
+
+void ClockSweepReplacer::Unpin(frame_id_t frame_id) {
+  ASSERT(static_cast<size_t>(frame_id) < num_frames_, "Invalid frame id.");
+  if ((states_[frame_id].fetch_or(EVICTABLE) & EVICTABLE) == 0) {
+    size_++;
+  }
+}
+
+size_t ClockSweepReplacer::Size() {
+  return size_.load();
+}
+
+void ClockSweepReplacer::SetFramePage(frame_id_t frame_id, __attribute__((unused)) page_tag_t page_tag) {
+  ASSERT(static_cast<size_t>(frame_id) < num_frames_, "Invalid frame id.");
+  // the usage count belonged to the previous page
+  states_[frame_id].fetch_and(EVICTABLE);
+}
+
+void ClockSweepReplacer::Resize(size_t num_pages) {
+  unique_ptr<atomic<uint32_t>[]> states(new atomic<uint32_t>[std::max<size_t>(1, num_pages)]);
+  size_t size = 0;
+  for (size_t i = 0; i < num_pages; i++) {
+    uint32_t current = i < num_frames_ ? states_[i].load() : 0;
+    states[i].store(current);
+    size += (current & EVICTABLE) != 0 ? 1 : 0;
+  }
+  states_ = std::move(states);
+  num_frames_ = num_pages;
+  size_.store(size);
+  hand_.store(0);
+}
@@ -0,0 +1,68 @@
+#include "buffer/compressed_page_cache.h"
+
+#include "common/lz_codec.h"
+
+CompressedPageCache::CompressedPageCache(size_t capacity) : capacity_(capacity) {}
+
+bool CompressedPageCache::Insert(page_tag_t page_tag, const char *data) {
+  Erase(page_tag);
+  if (capacity_ == 0) {
+    return false;
+  }
+  buffer_.resize(COMPRESSED_PAGE_MAX_SIZE);
+  size_t size = LZCodec::Compress(data, PAGE_SIZE, buffer_.data(), buffer_.size());
+  if (size == 0 || size > capacity_) {
+    return false;
+  }
+  entries_.push_front({page_tag, vector<char>(buffer_.begin(), buffer_.begin() + size)});
+  index_[page_tag] = entries_.begin();
+  size_ += size;
+  Trim();
+  return true;
+}
+
+bool CompressedPageCache::Take(page_tag_t page_tag, char *data) {
+  auto it = index_.find(page_tag);
+  if (it == index_.end()) {
+    return false;
+  }
+  const vector<char> &compressed = it->second->data_;
+  // a copy that does not decompress is dropped, the caller reads the page from disk instead
+  bool ok = LZCodec::Decompress(compressed.data(), compressed.size(), data, PAGE_SIZE);
+  EraseEntry(it->second);
+  return ok;
+}
+
+void CompressedPageCache::Erase(page_tag_t page_tag) {
+  auto it = index_.find(page_tag);
+  if (it != index_.end()) {
+    EraseEntry(it->second);
+  }
+}
+
+void CompressedPageCache::EraseFile(file_id_t file_id) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto next = std::next(it);
+    if (static_cast<file_id_t>(it->page_tag_ >> 32) == file_id) {
+      EraseEntry(it);
+    }
+    it = next;
+  }
+}
+
+void CompressedPageCache::SetCapacity(size_t capacity) {
+  capacity_ = capacity;
+  Trim();
+}
+
+void CompressedPageCache::EraseEntry(list<Entry>::iterator it) {
+  size_ -= it->data_.size();
+  index_.erase(it->page_tag_);
+  entries_.erase(it);
+}
+
+void CompressedPageCache::Trim() {
+  while (size_ > capacity_) {
+    EraseEntry(std::prev(entries_.end()));
+  }
+}
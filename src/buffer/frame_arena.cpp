@@ -0,0 +1,39 @@
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+FrameArena::FrameArena(size_t num_frames) : num_frames_(num_frames) {
+  size_t size = std::max<size_t>(1, num_frames_) * PAGE_SIZE;
+  // over-allocate by a huge page so the data can start on a huge page boundary
+  bool huge = size >= static_cast<size_t>(HUGE_PAGE_SIZE);
+  mapping_size_ = huge ? size + HUGE_PAGE_SIZE : size;
+  // no swap is reserved for the whole size, untouched frames cost nothing
+  mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mapping_ == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  auto start = reinterpret_cast<uintptr_t>(mapping_);
+  if (huge) {
+    start = (start + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+#ifdef MADV_HUGEPAGE
+    // only a hint, the arena works with normal pages if transparent huge pages are off
+    madvise(reinterpret_cast<void *>(start), size, MADV_HUGEPAGE);
+#endif
+  }
+  data_ = reinterpret_cast<char *>(start);
+}
+
+FrameArena::~FrameArena() {
+  munmap(mapping_, mapping_size_);
+}
+
+void FrameArena::Release(size_t first_frame_id, size_t num_frames) {
+  ASSERT(first_frame_id + num_frames <= num_frames_, "Frames out of the arena.");
+  if (num_frames != 0) {
+    madvise(GetFrame(first_frame_id), num_frames * PAGE_SIZE, MADV_DONTNEED);
+  }
+}
@@ -0,0 +1,129 @@
+#include "buffer/lru_k_replacer.h"
+
+#include "common/macros.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, uint64_t correlated_period)
+    : k_(k), correlated_period_(correlated_period), frames_(num_pages), retain_capacity_(num_pages) {
+  ASSERT(k_ > 0, "K must be positive.");
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+void LRUKReplacer::RecordAccess(FrameInfo &frame) {
+  uint64_t now = ++current_tick_;
+  History &history = frame.history_;
+  if (history.refs_.empty() || now - history.last_ > correlated_period_) {
+    history.refs_.push_front(now);
+    if (history.refs_.size() > k_) {
+      history.refs_.pop_back();
+    }
+  }
+  history.last_ = now;
+}
+
+void LRUKReplacer::MakeEvictable(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.history_.refs_.size() < k_) {
+    frame.key_ = make_pair(frame.history_.last_, frame_id);
+    cold_.insert(frame.key_);
+  } else {
+    frame.key_ = make_pair(frame.history_.refs_.back(), frame_id);
+    hot_.insert(frame.key_);
+  }
+  frame.evictable_ = true;
+}
+
+void LRUKReplacer::MakeUnevictable(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    if (cold_.erase(frame.key_) == 0) {
+      hot_.erase(frame.key_);
+    }
+    frame.evictable_ = false;
+  }
+}
+
+void LRUKReplacer::Evict(frame_id_t frame_id) {
+  MakeUnevictable(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+  // keep the history of the evicted page, forget the oldest one if there are too many
+  if (frame.page_tag_ != INVALID_PAGE_ID) {
+    retained_order_.push_front(frame.page_tag_);
+    retained_[frame.page_tag_] = make_pair(frame.history_, retained_order_.begin());
+    if (retained_.size() > retain_capacity_) {
+      retained_.erase(retained_order_.back());
+      retained_order_.pop_back();
+    }
+  }
+  frame = FrameInfo();
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  auto &candidates = cold_.empty() ? hot_ : cold_;
+  if (candidates.empty()) {
+    return false;
+  }
+  *frame_id = candidates.begin()->second;
+  Evict(*frame_id);
+  return true;
+}
+
+bool LRUKReplacer::PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) {
+  int depth = 0;
+  for (auto *candidates : {&cold_, &hot_}) {
+    for (auto it = candidates->begin(); it != candidates->end() && depth < VICTIM_SEARCH_DEPTH; ++it, ++depth) {
+      if (prefer(it->second)) {
+        *frame_id = it->second;
+        Evict(*frame_id);
+        return true;
+      }
+    }
+  }
+  return Victim(frame_id);
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Invalid frame id.");
+  MakeUnevictable(frame_id);
+  RecordAccess(frames_[frame_id]);
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Invalid frame id.");
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    return;
+  }
+  // a frame that was never pinned, like a page read ahead, is ordered by the unpin but not referenced by it
+  if (frame.history_.refs_.empty()) {
+    frame.history_.last_ = ++current_tick_;
+  }
+  MakeEvictable(frame_id);
+}
+
+size_t LRUKReplacer::Size() {
+  return cold_.size() + hot_.size();
+}
+
+void LRUKReplacer::SetFramePage(frame_id_t frame_id, page_tag_t page_tag) {
+  ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Invalid frame id.");
+  MakeUnevictable(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+  frame = FrameInfo();
+  frame.page_tag_ = page_tag;
+  auto it = retained_.find(page_tag);
+  if (it != retained_.end()) {
+    frame.history_ = it->second.first;
+    retained_order_.erase(it->second.second);
+    retained_.erase(it);
+  }
+}
+
+void LRUKReplacer::Resize(size_t num_pages) {
+  frames_.resize(num_pages);
+  retain_capacity_ = num_pages;
+  while (retained_.size() > retain_capacity_) {
+    retained_.erase(retained_order_.back());
+    retained_order_.pop_back();
+  }
+}
@@ -21,6 +21,19 @@ bool LRUReplacer::Victim(frame_id_t *frame_id) {
   return true;
 }
 
+bool LRUReplacer::PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) {
+  int depth = 0;
+  for (auto it = lru_list_.rbegin(); it != lru_list_.rend() && depth < VICTIM_SEARCH_DEPTH; ++it, ++depth) {
+    if (prefer(*it)) {
+      *frame_id = *it;
+      lru_list_.erase(std::next(it).base());
+      lru_list_map_.erase(*frame_id);
+      return true;
+    }
+  }
+  return Victim(frame_id);
+}
+
 /**
  * TODO: Student Implement
  */
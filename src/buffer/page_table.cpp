@@ -0,0 +1,88 @@
+#include "buffer/page_table.h"
+
+#include <utility>
+
+#include "common/macros.h"
+
+PageTable::PageTable(size_t num_frames) {
+  size_t capacity = 16;
+  shift_ = 60;
+  while (capacity < num_frames * 2) {
+    capacity <<= 1;
+    shift_--;
+  }
+  slots_.resize(capacity);
+  mask_ = capacity - 1;
+}
+
+void PageTable::Resize(size_t num_frames) {
+  ASSERT(num_frames >= size_, "Page table too small for its mappings.");
+  PageTable resized(num_frames);
+  if (resized.slots_.size() == slots_.size()) {
+    return;
+  }
+  for (const Slot &slot : slots_) {
+    if (slot.page_tag_ != INVALID_PAGE_ID) {
+      resized.Insert(slot.page_tag_, slot.frame_id_);
+    }
+  }
+  *this = std::move(resized);
+}
+
+size_t PageTable::Home(page_tag_t page_tag) const {
+  // Fibonacci hashing: page ids of one shard are an arithmetic progression, the high bits of the product spread them.
+  return (static_cast<uint64_t>(page_tag) * 11400714819323198485ull) >> shift_;
+}
+
+bool PageTable::Find(page_tag_t page_tag, frame_id_t *frame_id) const {
+  for (size_t i = Home(page_tag);; i = (i + 1) & mask_) {
+    const Slot &slot = slots_[i];
+    if (slot.page_tag_ == page_tag) {
+      *frame_id = slot.frame_id_;
+      return true;
+    }
+    if (slot.page_tag_ == INVALID_PAGE_ID) {
+      return false;
+    }
+  }
+}
+
+void PageTable::Insert(page_tag_t page_tag, frame_id_t frame_id) {
+  ASSERT(page_tag != INVALID_PAGE_ID, "Invalid page tag.");
+  for (size_t i = Home(page_tag);; i = (i + 1) & mask_) {
+    Slot &slot = slots_[i];
+    if (slot.page_tag_ == page_tag) {
+      slot.frame_id_ = frame_id;
+      return;
+    }
+    if (slot.page_tag_ == INVALID_PAGE_ID) {
+      ASSERT(size_ + 1 <= mask_, "Page table is full.");
+      slot.page_tag_ = page_tag;
+      slot.frame_id_ = frame_id;
+      size_++;
+      return;
+    }
+  }
+}
+
+bool PageTable::Erase(page_tag_t page_tag) {
+  size_t i = Home(page_tag);
+  while (slots_[i].page_tag_ != page_tag) {
+    if (slots_[i].page_tag_ == INVALID_PAGE_ID) {
+      return false;
+    }
+    i = (i + 1) & mask_;
+  }
+  // Backward shift: pull later members of the probe run into the hole as long as that keeps them reachable.
+  size_t hole = i;
+  for (size_t j = (hole + 1) & mask_; slots_[j].page_tag_ != INVALID_PAGE_ID; j = (j + 1) & mask_) {
+    size_t home = Home(slots_[j].page_tag_);
+    if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+      slots_[hole] = slots_[j];
+      hole = j;
+    }
+  }
+  slots_[hole] = Slot();
+  size_--;
+  return true;
+}
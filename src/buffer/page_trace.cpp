@@ -0,0 +1,133 @@
+#include "buffer/page_trace.h"
+
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <unordered_map>
+
+#include "glog/logging.h"
+
+/** @return a small number of the calling thread, handed out in the order threads first ask for one */
+static uint32_t TraceThreadNumber() {
+  static std::atomic<uint32_t> next_number{0};
+  thread_local uint32_t number = next_number++;
+  return number;
+}
+
+PageTraceWriter::PageTraceWriter(const string &file_name)
+    : file_(file_name, ios::binary | ios::out | ios::trunc), start_(std::chrono::steady_clock::now()) {
+  if (!file_.is_open()) {
+    LOG(ERROR) << "Cannot create page trace " << file_name << "." << std::endl;
+    return;
+  }
+  file_.write(PAGE_TRACE_MAGIC, PAGE_TRACE_MAGIC_SIZE);
+  buffer_.reserve(PAGE_TRACE_BUFFER_RECORDS);
+  is_open_ = true;
+}
+
+PageTraceWriter::~PageTraceWriter() {
+  Close();
+}
+
+void PageTraceWriter::Record(PageTraceOp op, file_id_t file_id, page_id_t page_id) {
+  auto now = std::chrono::steady_clock::now();
+  uint32_t thread = TraceThreadNumber();
+  lock_guard<mutex> guard(latch_);
+  if (!is_open_) {
+    return;
+  }
+  PageTraceRecord record;
+  record.timestamp_ = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_).count();
+  record.file_id_ = file_id;
+  record.page_id_ = page_id;
+  record.thread_ = thread;
+  record.op_ = op;
+  buffer_.push_back(record);
+  record_count_++;
+  if (buffer_.size() >= PAGE_TRACE_BUFFER_RECORDS) {
+    Flush();
+  }
+}
+
+void PageTraceWriter::Flush() {
+  file_.write(reinterpret_cast<const char *>(buffer_.data()), buffer_.size() * sizeof(PageTraceRecord));
+  buffer_.clear();
+}
+
+void PageTraceWriter::Close() {
+  lock_guard<mutex> guard(latch_);
+  if (!is_open_) {
+    return;
+  }
+  Flush();
+  file_.close();
+  is_open_ = false;
+}
+
+size_t PageTraceWriter::GetRecordCount() {
+  lock_guard<mutex> guard(latch_);
+  return record_count_;
+}
+
+PageTraceReader::PageTraceReader(const string &file_name) : file_(file_name, ios::binary | ios::in) {
+  char magic[PAGE_TRACE_MAGIC_SIZE];
+  if (file_.read(magic, PAGE_TRACE_MAGIC_SIZE) && memcmp(magic, PAGE_TRACE_MAGIC, PAGE_TRACE_MAGIC_SIZE) == 0) {
+    is_open_ = true;
+  }
+}
+
+bool PageTraceReader::Next(PageTraceRecord *record) {
+  return is_open_ && file_.read(reinterpret_cast<char *>(record), sizeof(PageTraceRecord));
+}
+
+TraceSimulation SimulateTrace(const vector<PageTraceRecord> &records, ReplacerType replacer_type, size_t pool_size) {
+  struct Resident {
+    frame_id_t frame_id_;
+    int pin_count_;
+  };
+  TraceSimulation result;
+  auto replacer = Replacer::Create(replacer_type, pool_size);
+  unordered_map<page_tag_t, Resident> page_table;
+  vector<page_tag_t> frames(pool_size, INVALID_PAGE_ID);
+  list<frame_id_t> free_list;
+  for (size_t i = 0; i < pool_size; i++) {
+    free_list.push_back(static_cast<frame_id_t>(i));
+  }
+  for (const auto &record : records) {
+    page_tag_t page_tag = static_cast<page_tag_t>(static_cast<uint64_t>(record.file_id_) << 32 |
+                                                  static_cast<uint32_t>(record.page_id_));
+    auto it = page_table.find(page_tag);
+    if (record.op_ == PageTraceOp::kUnpin) {
+      // the unpin of a page that found no frame is dropped along with it
+      if (it != page_table.end() && it->second.pin_count_ > 0 && --it->second.pin_count_ == 0) {
+        replacer->Unpin(it->second.frame_id_);
+      }
+      continue;
+    }
+    if (it != page_table.end()) {
+      if (record.op_ == PageTraceOp::kFetch) {
+        result.hits_++;
+      }
+      it->second.pin_count_++;
+      replacer->Pin(it->second.frame_id_);
+      continue;
+    }
+    frame_id_t frame_id = INVALID_FRAME_ID;
+    if (!free_list.empty()) {
+      frame_id = free_list.front();
+      free_list.pop_front();
+    } else if (replacer->Victim(&frame_id)) {
+      page_table.erase(frames[frame_id]);
+      result.evictions_++;
+    } else {
+      result.no_victims_++;
+      continue;
+    }
+    (record.op_ == PageTraceOp::kFetch ? result.misses_ : result.new_pages_)++;
+    frames[frame_id] = page_tag;
+    page_table[page_tag] = {frame_id, 1};
+    replacer->SetFramePage(frame_id, page_tag);
+    replacer->Pin(frame_id);
+  }
+  return result;
+}
@@ -0,0 +1,45 @@
+#include "buffer/read_ahead_window.h"
+
+#include <algorithm>
+
+#include "buffer/buffer_pool_manager.h"
+
+ReadAheadWindow::ReadAheadWindow(BufferPoolManager *buffer_pool_manager, NextPageFunc next_page_of, int distance,
+                                 BufferAccessStrategy *strategy)
+    : buffer_pool_manager_(buffer_pool_manager),
+      next_page_of_(next_page_of),
+      distance_(buffer_pool_manager == nullptr ? 0 : std::max(0, distance)),
+      strategy_(strategy) {
+  // pages read ahead into a ring must not recycle the frames the iterator is still using
+  if (strategy_ != nullptr) {
+    distance_ = std::min(distance_, std::max<size_t>(1, strategy_->GetRingSize() / 2));
+  }
+}
+
+void ReadAheadWindow::Advance(page_id_t page_id) {
+  if (distance_ == 0 || page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  // forget the requests up to the page the iterator is on, and all of them if it left the chain they were made for
+  auto it = std::find(requested_.begin(), requested_.end(), page_id);
+  auto passed = it == requested_.end() ? it : it + 1;
+  // an iterator faster than the I/O threads read these pages itself, the ones still queued are stale
+  for (auto stale = requested_.begin(); stale != passed; ++stale) {
+    buffer_pool_manager_->DropPrefetch(*stale);
+  }
+  requested_.erase(requested_.begin(), passed);
+  char data[PAGE_SIZE];
+  Page copy(data);
+  while (requested_.size() < distance_) {
+    page_id_t last_page_id = requested_.empty() ? page_id : requested_.back();
+    if (!buffer_pool_manager_->PeekPage(last_page_id, copy.GetData())) {
+      return;
+    }
+    page_id_t next_page_id = next_page_of_(&copy);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    buffer_pool_manager_->PrefetchPage(next_page_id, strategy_);
+    requested_.push_back(next_page_id);
+  }
+}
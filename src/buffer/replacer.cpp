@@ -0,0 +1,26 @@
+#include "buffer/replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/clock_sweep_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
+
+std::unique_ptr<Replacer> Replacer::Create(ReplacerType replacer_type, size_t num_pages) {
+  switch (replacer_type) {
+    case ReplacerType::kClock:
+      return std::make_unique<CLOCKReplacer>(num_pages);
+    case ReplacerType::kLRUK:
+      return std::make_unique<LRUKReplacer>(num_pages);
+    case ReplacerType::kTwoQueue:
+      return std::make_unique<TwoQueueReplacer>(num_pages);
+    case ReplacerType::kARC:
+      return std::make_unique<ARCReplacer>(num_pages);
+    case ReplacerType::kClockSweep:
+      return std::make_unique<ClockSweepReplacer>(num_pages);
+    case ReplacerType::kLRU:
+    default:
+      return std::make_unique<LRUReplacer>(num_pages);
+  }
+}
@@ -0,0 +1,137 @@
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_pages)
+    : kin_(std::max<size_t>(1, num_pages / 4)), kout_(std::max<size_t>(1, num_pages)), frames_(num_pages) {}
+
+TwoQueueReplacer::~TwoQueueReplacer() = default;
+
+void TwoQueueReplacer::Admit(frame_id_t frame_id, bool hot) {
+  FrameInfo &frame = frames_[frame_id];
+  frame.queue_ = hot ? Queue::kAm : Queue::kA1in;
+  frame.key_ = ++current_tick_;
+  if (!hot) {
+    a1in_size_++;
+  }
+}
+
+void TwoQueueReplacer::MakeUnevictable(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    (frame.queue_ == Queue::kA1in ? a1in_ : am_).erase(make_pair(frame.key_, frame_id));
+    frame.evictable_ = false;
+  }
+}
+
+set<pair<uint64_t, frame_id_t>> *TwoQueueReplacer::VictimQueue() {
+  if (!a1in_.empty() && (a1in_size_ > kin_ || am_.empty())) {
+    return &a1in_;
+  }
+  return am_.empty() ? nullptr : &am_;
+}
+
+void TwoQueueReplacer::Evict(frame_id_t frame_id) {
+  MakeUnevictable(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.queue_ == Queue::kA1in) {
+    a1in_size_--;
+    // only pages leaving A1in are remembered, pages leaving Am had their chance
+    if (frame.page_tag_ != INVALID_PAGE_ID) {
+      a1out_.push_front(frame.page_tag_);
+      a1out_map_[frame.page_tag_] = a1out_.begin();
+      if (a1out_.size() > kout_) {
+        a1out_map_.erase(a1out_.back());
+        a1out_.pop_back();
+      }
+    }
+  }
+  frame = FrameInfo();
+}
+
+bool TwoQueueReplacer::Victim(frame_id_t *frame_id) {
+  auto *queue = VictimQueue();
+  if (queue == nullptr) {
+    return false;
+  }
+  *frame_id = queue->begin()->second;
+  Evict(*frame_id);
+  return true;
+}
+
+bool TwoQueueReplacer::PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) {
+  auto *queue = VictimQueue();
+  if (queue == nullptr) {
+    return false;
+  }
+  int depth = 0;
+  for (auto it = queue->begin(); it != queue->end() && depth < VICTIM_SEARCH_DEPTH; ++it, ++depth) {
+    if (prefer(it->second)) {
+      *frame_id = it->second;
+      Evict(*frame_id);
+      return true;
+    }
+  }
+  return Victim(frame_id);
+}
+
+void TwoQueueReplacer::Pin(frame_id_t frame_id) {
+  ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Invalid frame id.");
+  MakeUnevictable(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.queue_ == Queue::kNone) {
+    Admit(frame_id, false);
+  } else if (frame.queue_ == Queue::kAm) {
+    frame.key_ = ++current_tick_;
+  }
+}
+
+void TwoQueueReplacer::Unpin(frame_id_t frame_id) {
+  ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Invalid frame id.");
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    return;
+  }
+  if (frame.queue_ == Queue::kNone) {
+    Admit(frame_id, false);
+  }
+  (frame.queue_ == Queue::kA1in ? a1in_ : am_).emplace(frame.key_, frame_id);
+  frame.evictable_ = true;
+}
+
+size_t TwoQueueReplacer::Size() {
+  return a1in_.size() + am_.size();
+}
+
+void TwoQueueReplacer::SetFramePage(frame_id_t frame_id, page_tag_t page_tag) {
+  ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Invalid frame id.");
+  MakeUnevictable(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.queue_ == Queue::kA1in) {
+    a1in_size_--;
+  }
+  frame = FrameInfo();
+  frame.page_tag_ = page_tag;
+  if (page_tag == INVALID_PAGE_ID) {
+    return;
+  }
+  auto it = a1out_map_.find(page_tag);
+  bool hot = it != a1out_map_.end();
+  if (hot) {
+    a1out_.erase(it->second);
+    a1out_map_.erase(it);
+  }
+  Admit(frame_id, hot);
+}
+
+void TwoQueueReplacer::Resize(size_t num_pages) {
+  frames_.resize(num_pages);
+  kin_ = std::max<size_t>(1, num_pages / 4);
+  kout_ = std::max<size_t>(1, num_pages);
+  while (a1out_.size() > kout_) {
+    a1out_map_.erase(a1out_.back());
+    a1out_.pop_back();
+  }
+}
@@ -79,6 +79,7 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
   else
   {
     Page *catalog_meta_page = buffer_pool_manager->FetchPage(CATALOG_META_PAGE_ID);
+    catalog_meta_page->SetPageType(PageType::kCatalog);
     char* buf=catalog_meta_page->GetData();
     catalog_meta_=CatalogMeta::DeserializeFrom(buf);
     buffer_pool_manager_->UnpinPage(catalog_meta_page->GetPageId(), false);
@@ -118,7 +119,8 @@ CatalogManager::~CatalogManager() {
 /**
  * TODO: Student Implement
  */
-dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema, Txn *txn, TableInfo *&table_info) {
+dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema, Txn *txn, TableInfo *&table_info,
+                                    uint32_t data_file) {
   // ASSERT(false, "Not Implemented yet");
   if(table_names_.find(table_name)!=table_names_.end())
   {
@@ -127,9 +129,11 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   page_id_t page_id;
   table_id_t table_id = catalog_meta_->GetNextTableId();
   page_id_t table_heap_root_id;
-  TablePage* table_heap_root_page = reinterpret_cast<TablePage*>(buffer_pool_manager_->NewPage(table_heap_root_id));
+  // the heap keeps growing in the data file of its first page
+  TablePage* table_heap_root_page =
+      reinterpret_cast<TablePage*>(buffer_pool_manager_->NewPage(table_heap_root_id, data_file));
   table_heap_root_page->Init(table_heap_root_id, INVALID_PAGE_ID, log_manager_, txn);
-  auto page=buffer_pool_manager_->NewPage(page_id);
+  auto page=buffer_pool_manager_->NewPage(page_id, data_file);
   catalog_meta_->table_meta_pages_.emplace(table_id,page_id);
   Schema *tmp_schema = Schema::DeepCopySchema(schema);
   TableHeap *table = TableHeap::Create(buffer_pool_manager_,table_heap_root_id,tmp_schema,log_manager_,lock_manager_);
@@ -137,7 +141,9 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   {
     return DB_FAILED;
   }
-  auto table_meta=TableMetadata::Create(table_id,table_name,table_heap_root_id,tmp_schema);
+  page->SetPageType(PageType::kCatalog);
+  auto table_meta =
+      TableMetadata::Create(table_id, table_name, table_heap_root_id, tmp_schema, table->GetFreeSpaceMapPageId());
   table_meta->SerializeTo(page->GetData());
   TableInfo* t_info = TableInfo::Create();
   t_info->Init(table_meta,table);
@@ -188,7 +194,7 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
  */
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Txn *txn, IndexInfo *&index_info,
-                                    const string &index_type) {
+                                    const string &index_type, uint32_t data_file) {
   // ASSERT(false, "Not Implemented yet");
   TableInfo* table_info=nullptr;
   if(GetTable(table_name,table_info)!=DB_SUCCESS)
@@ -209,12 +215,13 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   }
   index_id_t index_id = catalog_meta_->GetNextIndexId();
   page_id_t page_id;
-  auto page=buffer_pool_manager_->NewPage(page_id);
+  auto page=buffer_pool_manager_->NewPage(page_id, data_file);
   catalog_meta_->index_meta_pages_.emplace(index_id,page_id);
+  page->SetPageType(PageType::kCatalog);
   auto index_meta=IndexMetadata::Create(index_id,index_name,table_id,key_map);
   index_meta->SerializeTo(page->GetData());
   IndexInfo* i_info = IndexInfo::Create();
-  i_info->Init(index_meta,table_info,buffer_pool_manager_);
+  i_info->Init(index_meta,table_info,buffer_pool_manager_,data_file);
   if(index_names_.find(table_name)==index_names_.end())
   {
     std::unordered_map<std::string, index_id_t> map;
@@ -283,10 +290,11 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   }
   auto table_index=index_names_.find(table_name);
   table_id_t table_id = table_info->GetTableId();
-  page_id_t page_id = table_info->GetRootPageId();
   table_names_.erase(table_name);
   tables_.erase(table_id);
-  buffer_pool_manager_->DeletePage(page_id);
+  // every page of the heap goes back to the file, and so does the metadata page
+  table_info->GetTableHeap()->FreeTableHeap();
+  buffer_pool_manager_->DeletePage(catalog_meta_->table_meta_pages_[table_id]);
   catalog_meta_->table_meta_pages_.erase(table_id);
   FlushCatalogMetaPage();
   delete table_info;
@@ -306,18 +314,126 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
   index_id_t index_id = index_names_.find(table_name)->second.find(index_name)->second;
   index_names_.at(table_name).erase(index_name);
   indexes_.erase(index_id);
+  index_info->GetIndex()->Destroy();
   catalog_meta_->DeleteIndexMetaPage(buffer_pool_manager_, index_id);
   FlushCatalogMetaPage();
   delete index_info;
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::Vacuum(Txn *txn, uint64_t &released_pages) {
+  uint64_t file_pages = buffer_pool_manager_->GetFilePages();
+  // in the order the tables were created, each one fills the holes left by those before it
+  for (auto &table_meta_page : catalog_meta_->table_meta_pages_) {
+    auto table = tables_.find(table_meta_page.first);
+    if (table == tables_.end()) {
+      continue;
+    }
+    page_id_t first_page_id = table->second->GetTableHeap()->GetFirstPageId();
+    dberr_t res = RebuildTable(table->second, txn);
+    // the copy cannot take the pages of the table while it is built, if that put it past them it moves once more,
+    // into the pages the first copy freed
+    if (res == DB_SUCCESS && table->second->GetTableHeap()->GetFirstPageId() > first_page_id) {
+      res = RebuildTable(table->second, txn);
+    }
+    if (res != DB_SUCCESS) {
+      return res;
+    }
+  }
+  RelocateMetaPages(catalog_meta_->table_meta_pages_);
+  RelocateMetaPages(catalog_meta_->index_meta_pages_);
+  FlushCatalogMetaPage();
+  buffer_pool_manager_->TruncateFile();
+  // the copies may have grown the files for a while, only what the files lost in the end counts
+  uint64_t remaining_pages = buffer_pool_manager_->GetFilePages();
+  released_pages = file_pages > remaining_pages ? file_pages - remaining_pages : 0;
+  return DB_SUCCESS;
+}
+
+dberr_t CatalogManager::RebuildTable(TableInfo *table_info, Txn *txn) {
+  TableHeap *old_heap = table_info->GetTableHeap();
+  uint32_t data_file = DiskManager::DataFileOf(old_heap->GetFirstPageId());
+  std::vector<IndexInfo *> indexes;
+  GetTableIndexes(table_info->GetTableName(), indexes);
+  // the copies are built next to the table and its indexes, which are left as they are until every row made it over
+  TableHeap *heap =
+      TableHeap::Create(buffer_pool_manager_, table_info->GetSchema(), txn, log_manager_, lock_manager_, data_file);
+  index_id_t shadow_id = catalog_meta_->GetNextIndexId();
+  std::vector<Index *> shadows;
+  std::vector<uint32_t> index_files;
+  for (auto *index_info : indexes) {
+    index_files.push_back(DiskManager::DataFileOf(catalog_meta_->index_meta_pages_[index_info->GetIndexId()]));
+    shadows.push_back(index_info->CreateShadowIndex(buffer_pool_manager_, shadow_id + shadows.size(),
+                                                    index_files.back()));
+  }
+  bool copied = true;
+  for (auto it = old_heap->Begin(txn); copied && it != old_heap->End(); ++it) {
+    Row row(*it);
+    copied = heap->InsertTuple(row, txn);
+    for (size_t i = 0; copied && i < indexes.size(); i++) {
+      Row key_row;
+      row.GetKeyFromRow(table_info->GetSchema(), indexes[i]->GetIndexKeySchema(), key_row);
+      copied = shadows[i]->InsertEntry(key_row, row.GetRowId(), txn) == DB_SUCCESS;
+    }
+  }
+  if (!copied) {
+    for (auto *shadow : shadows) {
+      shadow->Destroy();
+      delete shadow;
+    }
+    heap->FreeTableHeap();
+    delete heap;
+    return DB_FAILED;
+  }
+  for (size_t i = 0; i < indexes.size(); i++) {
+    indexes[i]->ReplaceIndex(buffer_pool_manager_, shadows[i], shadow_id + i, index_files[i]);
+  }
+  old_heap->FreeTableHeap();
+  table_info->ResetTableHeap(heap);
+  heap->ReleaseUnusedPages();
+  // the first page of the heap moved
+  page_id_t meta_page_id = catalog_meta_->table_meta_pages_[table_info->GetTableId()];
+  Page *page = buffer_pool_manager_->FetchPage(meta_page_id);
+  if (page == nullptr) {
+    return DB_FAILED;
+  }
+  page->SetPageType(PageType::kCatalog);
+  table_info->GetTableMeta()->SerializeTo(page->GetData());
+  buffer_pool_manager_->UnpinPage(meta_page_id, true);
+  return DB_SUCCESS;
+}
+
+void CatalogManager::RelocateMetaPages(std::map<uint32_t, page_id_t> &meta_pages) {
+  for (auto &meta_page : meta_pages) {
+    page_id_t old_page_id = meta_page.second;
+    page_id_t new_page_id;
+    // same data file, the placement of an index is that of its metadata page
+    Page *new_page = buffer_pool_manager_->NewPage(new_page_id, DiskManager::DataFileOf(old_page_id));
+    if (new_page == nullptr) {
+      continue;
+    }
+    Page *old_page = new_page_id < old_page_id ? buffer_pool_manager_->FetchPage(old_page_id) : nullptr;
+    if (old_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(new_page_id, false);
+      buffer_pool_manager_->DeletePage(new_page_id);
+      continue;
+    }
+    memcpy(new_page->GetData(), old_page->GetData(), PAGE_SIZE);
+    new_page->SetPageType(PageType::kCatalog);
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+    buffer_pool_manager_->UnpinPage(old_page_id, false);
+    buffer_pool_manager_->DeletePage(old_page_id);
+    meta_page.second = new_page_id;
+  }
+}
+
 /**
  * TODO: Student Implement
  */
 dberr_t CatalogManager::FlushCatalogMetaPage() const {
   // ASSERT(false, "Not Implemented yet");
   auto meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
+  meta_page->SetPageType(PageType::kCatalog);
   catalog_meta_->SerializeTo(meta_page->GetData());
   buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, true);
   return DB_SUCCESS;
@@ -335,15 +451,24 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
   }
   catalog_meta_->table_meta_pages_[table_id] = page_id;
   Page* page=buffer_pool_manager_->FetchPage(page_id);
+  page->SetPageType(PageType::kCatalog);
   TableMetadata* table_meta = nullptr;
   TableMetadata::DeserializeFrom(page->GetData(),table_meta);
   auto schema=Schema::DeepCopySchema(table_meta->GetSchema());
-  TableHeap* heap=TableHeap::Create(buffer_pool_manager_,table_meta->GetFirstPageId(),schema,log_manager_,lock_manager_);
+  TableHeap *heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(), schema, log_manager_,
+                                      lock_manager_, table_meta->GetFreeSpaceMapPageId());
+  bool dirty = false;
+  if (heap->GetFreeSpaceMapPageId() != table_meta->GetFreeSpaceMapPageId()) {
+    // the table was written before it had a free-space map, the one built for it is kept from now on
+    table_meta->SetFreeSpaceMapPageId(heap->GetFreeSpaceMapPageId());
+    table_meta->SerializeTo(page->GetData());
+    dirty = true;
+  }
   table_info = TableInfo::Create();
   table_info->Init(table_meta,heap);
   table_names_.emplace(table_meta->GetTableName(),table_id);
   tables_.emplace(table_id,table_info);
-  //buffer_pool_manager_->UnpinPage(page_id, false);
+  buffer_pool_manager_->UnpinPage(page_id, dirty);
   return DB_SUCCESS;
 }
 
@@ -358,12 +483,14 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
     return DB_INDEX_ALREADY_EXIST;
   }
   auto page=buffer_pool_manager_->FetchPage(page_id);
+  page->SetPageType(PageType::kCatalog);
   IndexMetadata* index_meta=nullptr;
   IndexMetadata::DeserializeFrom(page->GetData(),index_meta);
   table_id_t table_id=index_meta->GetTableId();
   TableInfo* table_info=tables_.find(table_id)->second;
   index_info = IndexInfo::Create();
-  index_info->Init(index_meta,table_info,buffer_pool_manager_);
+  // the index stays in the data file of its metadata page
+  index_info->Init(index_meta,table_info,buffer_pool_manager_,DiskManager::DataFileOf(page_id));
   // auto *idx_roots = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID));
   // page_id_t index_root_page_id = INVALID_PAGE_ID;
   // idx_roots->GetRootId(index_id, &index_root_page_id);
@@ -380,8 +507,7 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
     index_names_.find(table_name)->second.emplace(index_name,index_id);
   }
   indexes_.emplace(index_id,index_info);
-  //buffer_pool_manager_->UnpinPage(page_id, false);
-  //buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  buffer_pool_manager_->UnpinPage(page_id, false);
   return DB_SUCCESS;
 }
 
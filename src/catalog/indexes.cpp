@@ -1,5 +1,7 @@
 #include "catalog/indexes.h"
 
+#include "page/index_roots_page.h"
+
 IndexMetadata::IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
                              const std::vector<uint32_t> &key_map)
     : index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map) {}
@@ -81,7 +83,8 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
   return buf - p;
 }
 
-Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type) {
+Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type, uint32_t data_file,
+                              index_id_t index_id) {
   size_t max_size = 0;
   uint32_t column_cnt = key_schema_->GetColumns().size();
   size_t size_bitmap = (column_cnt % 8) ? column_cnt / 8 + 1 : column_cnt / 8;
@@ -112,5 +115,22 @@ Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const stri
   } else {
     return nullptr;
   }
-  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager);
+  return new BPlusTreeIndex(index_id, key_schema_, max_size, buffer_pool_manager, data_file);
+}
+
+void IndexInfo::ReplaceIndex(BufferPoolManager *buffer_pool_manager, Index *shadow, index_id_t shadow_id,
+                             uint32_t data_file) {
+  index_->Destroy();
+  delete index_;
+  delete shadow;
+  // the copy takes over the entry of the index, the tree opened under the id of the index finds its root there
+  Page *page = buffer_pool_manager->FetchPage(INDEX_ROOTS_PAGE_ID);
+  page->SetPageType(PageType::kCatalog);
+  auto *index_roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  page_id_t root_page_id = INVALID_PAGE_ID;
+  index_roots_page->GetRootId(shadow_id, &root_page_id);
+  index_roots_page->Delete(shadow_id);
+  index_roots_page->Insert(meta_data_->index_id_, root_page_id);
+  buffer_pool_manager->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  index_ = CreateIndex(buffer_pool_manager, "bptree", data_file, meta_data_->index_id_);
 }
@@ -20,6 +20,11 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
   buf += 4;
   // table schema
   buf += schema_->SerializeTo(buf);
+  // free-space map
+  MACH_WRITE_UINT32(buf, TABLE_METADATA_FSM_MAGIC_NUM);
+  buf += 4;
+  MACH_WRITE_TO(page_id_t, buf, fsm_page_id_);
+  buf += 4;
   ASSERT(buf - p == ofs, "Unexpected serialize size.");
   return ofs;
 }
@@ -28,7 +33,7 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
  * TODO: Student Implement
  */
 uint32_t TableMetadata::GetSerializedSize() const {
-  return sizeof(uint32_t) + sizeof(table_id_t) + sizeof(uint32_t) + table_name_.length() + sizeof(page_id_t) + schema_->GetSerializedSize();
+  return sizeof(uint32_t) + sizeof(table_id_t) + sizeof(uint32_t) + table_name_.length() + sizeof(page_id_t) + schema_->GetSerializedSize() + sizeof(uint32_t) + sizeof(page_id_t);
 }
 
 /**
@@ -58,8 +63,15 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
   // // table schema
   TableSchema *schema = nullptr;
   buf += TableSchema::DeserializeFrom(buf, schema);
+  // free-space map, if the table has one yet
+  page_id_t fsm_page_id = INVALID_PAGE_ID;
+  if (MACH_READ_UINT32(buf) == TABLE_METADATA_FSM_MAGIC_NUM) {
+    buf += 4;
+    fsm_page_id = MACH_READ_FROM(page_id_t, buf);
+    buf += 4;
+  }
   // // allocate space for table metadata
-  table_meta = new TableMetadata(table_id, table_name, root_page_id, schema);
+  table_meta = new TableMetadata(table_id, table_name, root_page_id, schema, fsm_page_id);
   return buf - p;
 }
 
@@ -69,10 +81,15 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
  * @param heap Memory heap passed by TableInfo
  */
 TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                                     TableSchema *schema) {
+                                     TableSchema *schema, page_id_t fsm_page_id) {
   // allocate space for table metadata
-  return new TableMetadata(table_id, table_name, root_page_id, schema);
+  return new TableMetadata(table_id, table_name, root_page_id, schema, fsm_page_id);
 }
 
-TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema)
-    : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema) {}
+TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                             page_id_t fsm_page_id)
+    : table_id_(table_id),
+      table_name_(table_name),
+      root_page_id_(root_page_id),
+      schema_(schema),
+      fsm_page_id_(fsm_page_id) {}
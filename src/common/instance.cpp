@@ -3,16 +3,23 @@
 //
 #include "common/instance.h"
 
-DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size)
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size, ReplacerType replacer_type,
+                                 bool direct_io, bool compress_pages)
+    : DBStorageEngine(std::move(db_name), init, std::make_shared<BufferPool>(buffer_pool_size, replacer_type),
+                      direct_io, compress_pages) {}
+
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, std::shared_ptr<BufferPool> buffer_pool,
+                                 bool direct_io, bool compress_pages)
     : db_file_name_(std::move(db_name)), init_(init) {
   // Init database file if needed
   db_file_name_ = "./databases/" + db_file_name_;
   if (init_) {
-    remove(db_file_name_.c_str());
+    DiskManager::RemoveFiles(db_file_name_);
   }
   // Initialize components
-  disk_mgr_ = new DiskManager(db_file_name_);
-  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  disk_mgr_ = new DiskManager(db_file_name_, true, direct_io, init && compress_pages);
+  bpm_ = new BufferPoolManager(std::move(buffer_pool), disk_mgr_);
+  bpm_->StartFlusher();
 
   // Allocate static page for db storage engine
   if (init) {
@@ -23,12 +30,16 @@ DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer
     if (!bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID)) {
       throw logic_error("Header page not free.");
     }
-    if (bpm_->NewPage(id) == nullptr || id != CATALOG_META_PAGE_ID) {
+    Page *meta_page = bpm_->NewPage(id);
+    if (meta_page == nullptr || id != CATALOG_META_PAGE_ID) {
       throw logic_error("Failed to allocate catalog meta page.");
     }
-    if (bpm_->NewPage(id) == nullptr || id != INDEX_ROOTS_PAGE_ID) {
+    meta_page->SetPageType(PageType::kCatalog);
+    Page *roots_page = bpm_->NewPage(id);
+    if (roots_page == nullptr || id != INDEX_ROOTS_PAGE_ID) {
       throw logic_error("Failed to allocate header page.");
     }
+    roots_page->SetPageType(PageType::kCatalog);
     if (bpm_->IsPageFree(CATALOG_META_PAGE_ID) || bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID)) {
       exit(1);
     }
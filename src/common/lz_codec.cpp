@@ -0,0 +1,159 @@
+#include "common/lz_codec.h"
+
+#include <cstring>
+
+namespace {
+
+uint32_t Read32(const uint8_t *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+/**
+ * Append the extra bytes of a length whose nibble was saturated at 15.
+ * @return false if they did not fit
+ */
+bool PutLength(size_t length, uint8_t *&out, const uint8_t *out_end) {
+  for (; length >= 255; length -= 255) {
+    if (out >= out_end) {
+      return false;
+    }
+    *out++ = 255;
+  }
+  if (out >= out_end) {
+    return false;
+  }
+  *out++ = static_cast<uint8_t>(length);
+  return true;
+}
+
+/**
+ * Read the extra bytes of a length whose nibble was 15 and add them to it.
+ * @return false if the input ended first
+ */
+bool GetLength(size_t &length, const uint8_t *&in, const uint8_t *in_end) {
+  uint8_t byte;
+  do {
+    if (in >= in_end) {
+      return false;
+    }
+    byte = *in++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+}  // namespace
+
+size_t LZCodec::Compress(const char *src, size_t size, char *dst, size_t capacity) {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  const uint8_t *in_end = in + size;
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  const uint8_t *out_end = out + capacity;
+  // positions + 1 of the last 4-byte prefixes seen, 0 for none
+  uint32_t table[1 << LZ_HASH_BITS] = {0};
+
+  const uint8_t *anchor = in;  // first byte not yet emitted
+  const uint8_t *ip = in;
+  const uint8_t *match_limit = size > LZ_LAST_LITERALS ? in_end - LZ_LAST_LITERALS : in;
+  while (ip + LZ_MIN_MATCH <= match_limit) {
+    uint32_t sequence = Read32(ip);
+    uint32_t hash = (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+    uint32_t candidate = table[hash];
+    table[hash] = static_cast<uint32_t>(ip - in) + 1;
+    if (candidate == 0) {
+      ip++;
+      continue;
+    }
+    const uint8_t *ref = in + candidate - 1;
+    if (static_cast<size_t>(ip - ref) > LZ_MAX_OFFSET || Read32(ref) != sequence) {
+      ip++;
+      continue;
+    }
+    // extend the match as far as the last literals allow
+    const uint8_t *match_end = ip + LZ_MIN_MATCH;
+    ref += LZ_MIN_MATCH;
+    while (match_end < match_limit && *match_end == *ref) {
+      match_end++;
+      ref++;
+    }
+    size_t literals = ip - anchor;
+    size_t match_length = match_end - ip - LZ_MIN_MATCH;
+    // token, literals, offset and at most a few length bytes
+    if (out + 1 + literals + literals / 255 + 2 + match_length / 255 + 2 > out_end) {
+      return 0;
+    }
+    uint8_t *token = out++;
+    *token = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4 | (match_length >= 15 ? 15 : match_length));
+    if (literals >= 15 && !PutLength(literals - 15, out, out_end)) {
+      return 0;
+    }
+    memcpy(out, anchor, literals);
+    out += literals;
+    size_t offset = match_end - ref;
+    *out++ = static_cast<uint8_t>(offset);
+    *out++ = static_cast<uint8_t>(offset >> 8);
+    if (match_length >= 15 && !PutLength(match_length - 15, out, out_end)) {
+      return 0;
+    }
+    ip = match_end;
+    anchor = ip;
+  }
+  // the last sequence carries the remaining literals only
+  size_t literals = in_end - anchor;
+  if (out + 1 + literals + literals / 255 + 1 > out_end) {
+    return 0;
+  }
+  *out++ = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+  if (literals >= 15 && !PutLength(literals - 15, out, out_end)) {
+    return 0;
+  }
+  memcpy(out, anchor, literals);
+  out += literals;
+  return out - reinterpret_cast<uint8_t *>(dst);
+}
+
+bool LZCodec::Decompress(const char *src, size_t size, char *dst, size_t dst_size) {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  const uint8_t *in_end = in + size;
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  uint8_t *out_begin = out;
+  uint8_t *out_end = out + dst_size;
+  while (in < in_end) {
+    uint8_t token = *in++;
+    size_t literals = token >> 4;
+    if (literals == 15 && !GetLength(literals, in, in_end)) {
+      return false;
+    }
+    if (literals > static_cast<size_t>(in_end - in) || literals > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    memcpy(out, in, literals);
+    in += literals;
+    out += literals;
+    if (in == in_end) {
+      break;
+    }
+    if (in_end - in < 2) {
+      return false;
+    }
+    size_t offset = in[0] | in[1] << 8;
+    in += 2;
+    size_t match_length = token & 15;
+    if (match_length == 15 && !GetLength(match_length, in, in_end)) {
+      return false;
+    }
+    match_length += LZ_MIN_MATCH;
+    if (offset == 0 || offset > static_cast<size_t>(out - out_begin) ||
+        match_length > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    // byte by byte, the match may overlap the bytes it produces
+    const uint8_t *ref = out - offset;
+    for (size_t i = 0; i < match_length; i++) {
+      *out++ = *ref++;
+    }
+  }
+  return out == out_end;
+}
@@ -5,6 +5,7 @@
 #include <sys/types.h>
 
 #include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include "common/result_writer.h"
 #include "executor/executors/delete_executor.h"
@@ -23,7 +24,10 @@ int yyparse(void);
 #include "parser/parser.h"
 }
 
-ExecuteEngine::ExecuteEngine() {
+// where SET page_trace = 1 records the page accesses, outside ./databases so it is not taken for a database
+static const char *PAGE_TRACE_FILE_NAME = "./page_trace.bin";
+
+ExecuteEngine::ExecuteEngine() : buffer_pool_(std::make_shared<BufferPool>(DEFAULT_BUFFER_POOL_SIZE)) {
   char path[] = "./databases";
   DIR *dir;
   if ((dir = opendir(path)) == nullptr) {
@@ -39,9 +43,11 @@ ExecuteEngine::ExecuteEngine() {
         strcmp( stdir->d_name , "..") == 0 ||
         stdir->d_name[0] == '.')
       continue;
-    dbs_[stdir->d_name] = new DBStorageEngine(stdir->d_name, false);
+    // opened by the first USE, an unused database costs neither memory nor the time to load its catalog
+    dbs_[stdir->d_name] = nullptr;
   }
   closedir(dir);
+  buffer_pool_->StartFlusher();
 }
 
 std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *exec_ctx,
@@ -142,6 +148,12 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteExecfile(ast, context.get());
     case kNodeQuit:
       return ExecuteQuit(ast, context.get());
+    case kNodeSet:
+      return ExecuteSet(ast, context.get());
+    case kNodeShowStatus:
+      return ExecuteShowStatus(ast, context.get());
+    case kNodeVacuum:
+      return ExecuteVacuum(ast, context.get());
     default:
       break;
   }
@@ -151,7 +163,9 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
   try {
     planner.PlanQuery(ast);
     // Execute the query.
-    ExecutePlan(planner.plan_, &result_set, nullptr, context.get());
+    if (ExecutePlan(planner.plan_, &result_set, nullptr, context.get()) != DB_SUCCESS) {
+      return DB_FAILED;
+    }
   } catch (const exception &ex) {
     std::cout << "Error Encountered in Planner: " << ex.what() << std::endl;
     return DB_FAILED;
@@ -249,7 +263,7 @@ dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *co
   if (dbs_.find(db_name) != dbs_.end()) {
     return DB_ALREADY_EXIST;
   }
-  dbs_.insert(make_pair(db_name, new DBStorageEngine(db_name, true)));
+  dbs_.insert(make_pair(db_name, new DBStorageEngine(db_name, true, buffer_pool_, false, compress_pages_)));
   return DB_SUCCESS;
 }
 
@@ -261,7 +275,7 @@ dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *cont
   if (dbs_.find(db_name) == dbs_.end()) {
     return DB_NOT_EXIST;
   }
-  remove(("./databases/" + db_name).c_str());
+  DiskManager::RemoveFiles("./databases/" + db_name);
   delete dbs_[db_name];
   dbs_.erase(db_name);
   if(db_name == current_db_){
@@ -297,8 +311,14 @@ dberr_t ExecuteEngine::ExecuteUseDatabase(pSyntaxNode ast, ExecuteContext *conte
   LOG(INFO) << "ExecuteUseDatabase" << std::endl;
 #endif
   string db_name = ast->child_->val_;
-  if (dbs_.find(db_name) != dbs_.end()) {
+  auto it = dbs_.find(db_name);
+  if (it != dbs_.end()) {
+    if (it->second == nullptr) {
+      it->second = new DBStorageEngine(db_name, false, buffer_pool_);
+    }
     current_db_ = db_name;
+    // placement is per database, new objects go to the first data file until SET data_file says otherwise
+    data_file_ = 0;
     cout << "Database changed" << endl;
     return DB_SUCCESS;
   }
@@ -344,6 +364,10 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
     LOG(ERROR) << "No database selected." << std::endl;
     return DB_FAILED;
   }
+  if (data_file_ >= dbs_[current_db_]->disk_mgr_->GetDataFileCount()) {
+    LOG(ERROR) << "Database " << current_db_ << " has no data file " << data_file_ << "." << std::endl;
+    return DB_FAILED;
+  }
   string table_name = ast->child_->val_;
   vector<string> primary_keys, unique_keys, column_names;
   unordered_set<string> primary_key_set;
@@ -414,20 +438,21 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
   }
   Schema *schema = new Schema(columns, should_manage);
   TableInfo *table_info;
-  dberr_t res = context->GetCatalog()->CreateTable(table_name, schema, context->GetTransaction(), table_info);
+  dberr_t res =
+      context->GetCatalog()->CreateTable(table_name, schema, context->GetTransaction(), table_info, data_file_);
   if (res != DB_SUCCESS) {
     return res;
   }
   if (!primary_keys.empty()) {
     IndexInfo *index_info;
     res = context->GetCatalog()->CreateIndex(table_info->GetTableName(), table_name + "_PK_IDX", primary_keys,
-                                             context->GetTransaction(), index_info, "bptree");
+                                             context->GetTransaction(), index_info, "bptree", data_file_);
     for (auto key : unique_keys) {
       string index_name = "UNIQUE_";
       index_name += key + "_";
       index_name += "ON_" + table_name;
       context->GetCatalog()->CreateIndex(table_name, index_name, unique_keys, context->GetTransaction(), index_info,
-                                         "btree");
+                                         "btree", data_file_);
     }
     if (res != DB_SUCCESS) {
       return res;
@@ -548,9 +573,13 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   if (res != DB_SUCCESS) {
     return res;
   }
+  if (data_file_ >= dbs_[current_db_]->disk_mgr_->GetDataFileCount()) {
+    LOG(ERROR) << "Database " << current_db_ << " has no data file " << data_file_ << "." << std::endl;
+    return DB_FAILED;
+  }
   IndexInfo *index_info;
   res = dbs_[current_db_]->catalog_mgr_->CreateIndex(table_name, index_name, column_names, context->GetTransaction(), index_info,
-                                           index_type);
+                                           index_type, data_file_);
   if (res != DB_SUCCESS) {
     return res;
   }
@@ -558,7 +587,7 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   // Insert old records into the new index.
   auto txn= context->GetTransaction();
   auto table_heap = table_info->GetTableHeap();
-  for (auto row = table_heap->Begin(txn); row != table_heap->End(); row++) {
+  for (auto row = table_heap->Begin(txn); row != table_heap->End(); ++row) {
     auto row_id = row->GetRowId();
     // Get related fields.
     vector<Field> fields;
@@ -700,3 +729,205 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
 #endif
   return DB_QUIT;
 }
+
+dberr_t ExecuteEngine::ExecuteSet(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteSet" << std::endl;
+#endif
+  string variable = ast->child_->val_;
+  string value = ast->child_->next_->val_;
+  if (variable == "page_trace") {
+    // 1 starts recording the page accesses of the buffer pool, 0 stops, see the trace_sim tool
+    if (value == "0") {
+      size_t records = buffer_pool_->StopTrace();
+      cout << "Page trace stopped, " << records << " operations recorded." << endl;
+      return DB_SUCCESS;
+    }
+    if (value != "1") {
+      LOG(ERROR) << "page_trace must be 0 or 1." << std::endl;
+      return DB_FAILED;
+    }
+    if (!buffer_pool_->StartTrace(PAGE_TRACE_FILE_NAME)) {
+      return DB_FAILED;
+    }
+    cout << "Recording page trace to " << PAGE_TRACE_FILE_NAME << "." << endl;
+    return DB_SUCCESS;
+  }
+  if (variable == "data_files" || variable == "data_file") {
+    return ExecuteSetDataFiles(variable, value);
+  }
+  if (variable == "page_compression") {
+    // 1 stores the pages of the databases created from now on compressed, a database keeps the format it was created in
+    if (value != "0" && value != "1") {
+      LOG(ERROR) << "page_compression must be 0 or 1." << std::endl;
+      return DB_FAILED;
+    }
+    compress_pages_ = value == "1";
+    cout << "Databases created from now on store their pages " << (compress_pages_ ? "compressed" : "uncompressed")
+         << "." << endl;
+    return DB_SUCCESS;
+  }
+  if (variable != "buffer_pool_size" && variable != "compressed_cache_size") {
+    LOG(ERROR) << "Unknown variable " << variable << "." << std::endl;
+    return DB_FAILED;
+  }
+  if (value.find_first_not_of("0123456789") != string::npos) {
+    LOG(ERROR) << variable << " must be a number of pages." << std::endl;
+    return DB_FAILED;
+  }
+  if (variable == "compressed_cache_size") {
+    // the memory of that many pages holds their compressed copies, 0 turns the cache off
+    size_t pages = std::min<size_t>(strtoull(value.c_str(), nullptr, 10), BUFFER_POOL_MAX_SIZE);
+    buffer_pool_->SetCompressedCacheSize(pages * PAGE_SIZE);
+    cout << "Compressed cache set to " << pages << " pages of memory." << endl;
+    return DB_SUCCESS;
+  }
+  // out of range values, overflow included, are turned down by the buffer pool
+  size_t pool_size = strtoull(value.c_str(), nullptr, 10);
+  if (!buffer_pool_->Resize(pool_size)) {
+    return DB_FAILED;
+  }
+  cout << "Buffer pool resized to " << pool_size << " pages." << endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteSetDataFiles(const string &variable, const string &value) {
+  if (current_db_.empty()) {
+    cout << "No database selected" << endl;
+    return DB_FAILED;
+  }
+  if (value.find_first_not_of("0123456789") != string::npos) {
+    LOG(ERROR) << variable << " must be a number of data files." << std::endl;
+    return DB_FAILED;
+  }
+  DiskManager *disk_manager = dbs_[current_db_]->disk_mgr_;
+  uint32_t count = disk_manager->GetDataFileCount();
+  uint32_t number = std::min<uint64_t>(strtoull(value.c_str(), nullptr, 10), MAX_DATA_FILES);
+  if (variable == "data_file") {
+    // data file the tables and indexes created from now on are placed in
+    if (number >= count) {
+      LOG(ERROR) << "Database " << current_db_ << " has " << count << " data files." << std::endl;
+      return DB_FAILED;
+    }
+    data_file_ = number;
+    cout << "New tables and indexes go to " << disk_manager->GetDataFileName(number) << "." << endl;
+    return DB_SUCCESS;
+  }
+  // the new files are hidden next to the database so they are not listed as databases, a link created at the path of
+  // one beforehand puts it on another disk
+  for (; count < number; count++) {
+    string file_name = "./databases/." + current_db_ + "." + std::to_string(count);
+    if (disk_manager->AddDataFile(file_name) == 0) {
+      return DB_FAILED;
+    }
+  }
+  cout << "Database " << current_db_ << " has " << disk_manager->GetDataFileCount() << " data files." << endl;
+  return DB_SUCCESS;
+}
+
+/**
+ * Print rows in a box the way the other SHOW statements do, one column per header.
+ */
+static void PrintTable(const vector<string> &header, const vector<vector<string>> &rows) {
+  vector<size_t> widths;
+  for (const auto &title : header) {
+    widths.push_back(title.length());
+  }
+  for (const auto &row : rows) {
+    for (size_t i = 0; i < row.size(); i++) {
+      widths[i] = std::max(widths[i], row[i].length());
+    }
+  }
+  auto print_border = [&widths] {
+    for (size_t width : widths) {
+      cout << "+" << setfill('-') << setw(width + 2) << "";
+    }
+    cout << "+" << endl;
+  };
+  auto print_row = [&widths](const vector<string> &row) {
+    for (size_t i = 0; i < row.size(); i++) {
+      cout << "| " << std::left << setfill(' ') << setw(widths[i]) << row[i] << " ";
+    }
+    cout << "|" << endl;
+  };
+  print_border();
+  print_row(header);
+  print_border();
+  for (const auto &row : rows) {
+    print_row(row);
+  }
+  print_border();
+}
+
+dberr_t ExecuteEngine::ExecuteShowStatus(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteShowStatus" << std::endl;
+#endif
+  BufferPoolStats stats = buffer_pool_->GetStats();
+  auto hit_ratio = [](const PageTypeStats &counters) {
+    size_t fetches = counters.hits_ + counters.misses_;
+    stringstream ss;
+    ss << std::fixed << setprecision(2) << (fetches == 0 ? 0.0 : 100.0 * counters.hits_ / fetches) << "%";
+    return ss.str();
+  };
+  auto type_row = [&hit_ratio](const string &name, const PageTypeStats &counters) {
+    return vector<string>{name,
+                          to_string(counters.hits_),
+                          to_string(counters.misses_),
+                          hit_ratio(counters),
+                          to_string(counters.evictions_),
+                          to_string(counters.dirty_evictions_),
+                          to_string(counters.write_backs_),
+                          to_string(counters.pin_waits_)};
+  };
+  vector<vector<string>> type_rows;
+  for (size_t i = 0; i < NUM_PAGE_TYPES; i++) {
+    auto page_type = static_cast<PageType>(i);
+    type_rows.push_back(type_row(PageTypeToString(page_type), stats.Total(page_type)));
+  }
+  type_rows.push_back(type_row("total", stats.Total()));
+  PrintTable({"Page type", "Hits", "Misses", "Hit ratio", "Evictions", "Dirty evictions", "Write-backs", "Pin waits"},
+             type_rows);
+  vector<vector<string>> shard_rows;
+  for (size_t i = 0; i < stats.shards_.size(); i++) {
+    const ShardStats &shard = stats.shards_[i];
+    PageTypeStats total = shard.Total();
+    shard_rows.push_back({to_string(i), to_string(shard.frames_), to_string(shard.free_frames_),
+                          to_string(shard.replacer_size_), to_string(total.hits_), to_string(total.misses_),
+                          hit_ratio(total), to_string(total.evictions_), to_string(shard.prefetches_),
+                          to_string(shard.compressed_pages_), to_string(shard.compressed_hits_)});
+  }
+  PrintTable({"Shard", "Frames", "Free", "Evictable", "Hits", "Misses", "Hit ratio", "Evictions", "Prefetches",
+              "Compressed", "Compressed hits"},
+             shard_rows);
+  cout << "Pool size " << stats.pool_size_ << " pages, at most " << stats.max_pool_size_ << ", "
+       << stats.shards_.size() << " shards." << endl;
+  if (stats.compressed_cache_size_ != 0) {
+    size_t pages = 0;
+    size_t bytes = 0;
+    for (const ShardStats &shard : stats.shards_) {
+      pages += shard.compressed_pages_;
+      bytes += shard.compressed_bytes_;
+    }
+    cout << "Compressed cache " << bytes << " of " << stats.compressed_cache_size_ << " bytes, " << pages
+         << " pages." << endl;
+  }
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteVacuum" << std::endl;
+#endif
+  if (current_db_.empty()) {
+    LOG(ERROR) << "No database selected." << std::endl;
+    return DB_FAILED;
+  }
+  uint64_t released_pages = 0;
+  dberr_t result = dbs_[current_db_]->catalog_mgr_->Vacuum(context->GetTransaction(), released_pages);
+  if (result == DB_SUCCESS) {
+    cout << "Database " << current_db_ << " compacted, " << released_pages << " pages returned to the file system."
+         << endl;
+  }
+  return result;
+}
@@ -6,13 +6,18 @@ class RowidCompare {
 };
 
 IndexScanExecutor::IndexScanExecutor(ExecuteContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx), plan_(plan) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), iterator_(nullptr, RowId(INVALID_PAGE_ID, 0), nullptr) {}
 
 void IndexScanExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
-  auto first_row = table_info_->GetTableHeap()->Begin(nullptr);
+  iterator_ = TableIterator(table_info_->GetTableHeap(), RowId(INVALID_PAGE_ID, 0), exec_ctx_->GetTransaction());
   result_ = IndexScan(plan_->GetPredicate());
+  cursor_ = 0;
   is_schema_same_ = SchemaEqual(table_info_->GetSchema(), plan_->OutputSchema());
+  column_indexes_.clear();
+  for (const auto column : plan_->OutputSchema()->GetColumns()) {
+    column_indexes_.push_back(column->GetTableInd());
+  }
 }
 
 bool IndexScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *output_schema) {
@@ -84,21 +89,24 @@ vector<RowId> IndexScanExecutor::IndexScan(AbstractExpressionRef predicate) {
 
 bool IndexScanExecutor::Next(Row *row, RowId *rid) {
   auto predicate = plan_->GetPredicate();
-  auto table_schema = table_info_->GetSchema();
   while (cursor_ < result_.size()) {
-    auto p_row = new Row(result_[cursor_]);
-    table_info_->GetTableHeap()->GetTuple(p_row, nullptr);
+    // rows next to each other in the index often share a page, the iterator keeps it pinned between them
+    if (!iterator_.Seek(result_[cursor_])) {
+      cursor_++;
+      continue;
+    }
+    const RowView &view = iterator_.GetRowView();
     if (plan_->need_filter_) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
+      if (!predicate->EvaluateView(&view).CompareEquals(Field(kTypeInt, 1))) {
         cursor_++;
         continue;
       }
     }
     *rid = result_[cursor_];
     if (!is_schema_same_) {
-      TupleTransfer(table_schema, plan_->OutputSchema(), p_row, row);
+      view.GetRow(column_indexes_, row);
     } else {
-      *row = *p_row;
+      view.GetRow(row);
     }
     cursor_++;
     return true;
@@ -4,6 +4,9 @@
 
 #include "executor/executors/insert_executor.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 InsertExecutor::InsertExecutor(ExecuteContext *exec_ctx, const InsertPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
@@ -13,30 +16,95 @@ void InsertExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
   schema_ = table_info_->GetSchema();
   exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->GetTableName(), index_info_);
+  rows_.clear();
+  cursor_ = 0;
+  drained_ = false;
 }
 
 bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-    Row insert_row;
-    RowId insert_rid;
-    if (child_executor_->Next(&insert_row, &insert_rid)) {
-        for (auto info: index_info_) {
-            Row key_row;
-            insert_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
-            std::vector<RowId> result;
-            if (!key_row.GetFields().empty() &&
-                info->GetIndex()->ScanKey(key_row, result, exec_ctx_->GetTransaction()) == DB_SUCCESS) {
-                std::cout << "key already exists" << std::endl;
-                return false;
-            }
+  if (!drained_) {
+    Row child_row;
+    RowId child_rid;
+    while (child_executor_->Next(&child_row, &child_rid)) {
+      rows_.push_back(child_row);
+    }
+    drained_ = true;
+    if (rows_.size() >= BULK_INSERT_MIN_ROWS) {
+      InsertBatch();
+    } else {
+      InsertRows();
+    }
+  }
+  // every row is in, the remaining calls only report them
+  return cursor_++ < rows_.size();
+}
+
+void InsertExecutor::InsertRows() {
+  auto txn = exec_ctx_->GetTransaction();
+  std::vector<std::pair<Index *, Row>> added;
+  for (size_t inserted = 0; inserted < rows_.size(); inserted++) {
+    Row &insert_row = rows_[inserted];
+    if (!table_info_->GetTableHeap()->InsertTuple(insert_row, txn)) {
+      Undo(added, inserted);
+      throw std::runtime_error("row too large, no row was inserted");
+    }
+    for (auto info : index_info_) {
+      Row key_row;
+      insert_row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
+      if (info->GetIndex()->InsertEntry(key_row, insert_row.GetRowId(), txn) != DB_SUCCESS) {
+        Undo(added, inserted + 1);
+        throw std::runtime_error("key already exists, no row was inserted");
+      }
+      added.emplace_back(info->GetIndex(), key_row);
+    }
+  }
+}
+
+void InsertExecutor::InsertBatch() {
+  auto txn = exec_ctx_->GetTransaction();
+  size_t inserted = table_info_->GetTableHeap()->BulkInsert(rows_, txn);
+  if (inserted != rows_.size()) {
+    Undo({}, inserted);
+    throw std::runtime_error("row too large, no row was inserted");
+  }
+  // keys already in an index are found by the index while it takes them, not probed for row by row
+  std::vector<std::pair<Index *, Row>> added;
+  for (auto info : index_info_) {
+    std::vector<Row> keys(rows_.size());
+    std::vector<size_t> order(rows_.size());
+    for (size_t i = 0; i < rows_.size(); i++) {
+      rows_[i].GetKeyFromRow(schema_, info->GetIndexKeySchema(), keys[i]);
+      order[i] = i;
+    }
+    // keys in ascending order go to neighbouring leaves, which are still in the buffer pool
+    std::sort(order.begin(), order.end(), [&keys](size_t a, size_t b) {
+      for (uint32_t i = 0; i < keys[a].GetFieldCount(); i++) {
+        if (keys[a].GetField(i)->CompareLessThan(*keys[b].GetField(i)) == CmpBool::kTrue) {
+          return true;
         }
-        if (table_info_->GetTableHeap()->InsertTuple(insert_row, exec_ctx_->GetTransaction())) {
-            Row key_row;
-            for (auto info: index_info_) {  // 更新索引
-                insert_row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
-                info->GetIndex()->InsertEntry(key_row, insert_row.GetRowId(), exec_ctx_->GetTransaction());
-            }
-            return true;
+        if (keys[a].GetField(i)->CompareGreaterThan(*keys[b].GetField(i)) == CmpBool::kTrue) {
+          return false;
         }
+      }
+      return false;
+    });
+    for (auto i : order) {
+      if (info->GetIndex()->InsertEntry(keys[i], rows_[i].GetRowId(), txn) != DB_SUCCESS) {
+        Undo(added, inserted);
+        throw std::runtime_error("key already exists, no row was inserted");
+      }
+      added.emplace_back(info->GetIndex(), keys[i]);
+    }
+  }
+}
+
+void InsertExecutor::Undo(const std::vector<std::pair<Index *, Row>> &added, size_t inserted) {
+  auto txn = exec_ctx_->GetTransaction();
+  for (auto &entry : added) {
+    entry.first->RemoveEntry(entry.second, RowId(), txn);
+  }
+  for (size_t i = 0; i < inserted; i++) {
+    table_info_->GetTableHeap()->ApplyDelete(rows_[i].GetRowId(), txn);
   }
-  return false;
+  rows_.clear();
 }
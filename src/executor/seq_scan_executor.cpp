@@ -40,30 +40,36 @@ void SeqScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *ou
 
 void SeqScanExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
-  auto first_row = table_info_->GetTableHeap()->Begin(nullptr);
-  iterator_ = (table_info_->GetTableHeap()->Begin(exec_ctx_->GetTransaction()));
+  // a page pinned by a previous scan is let go before the ring it was read into
+  iterator_ = table_info_->GetTableHeap()->End();
+  strategy_ = std::make_unique<BufferAccessStrategy>(exec_ctx_->GetBufferPoolManager());
+  iterator_ = (table_info_->GetTableHeap()->Begin(exec_ctx_->GetTransaction(), strategy_.get()));
   schema_ = plan_->OutputSchema();
   is_schema_same_ = SchemaEqual(table_info_->GetSchema(), schema_);
+  column_indexes_.clear();
+  for (const auto column : schema_->GetColumns()) {
+    column_indexes_.push_back(column->GetTableInd());
+  }
 }
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
   auto predicate = plan_->GetPredicate();
-  auto table_schema = table_info_->GetSchema();
   while (iterator_ != table_info_->GetTableHeap()->End()) {
-    auto p_row = &(*iterator_);
+    // the row is read in the page, only the columns the predicate and the output look at are decoded
+    const RowView &view = iterator_.GetRowView();
     if (predicate != nullptr) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
-        iterator_++;
+      if (!predicate->EvaluateView(&view).CompareEquals(Field(kTypeInt, 1))) {
+        ++iterator_;
         continue;
       }
     }
-    *rid = iterator_->GetRowId();
+    *rid = view.GetRowId();
     if (!is_schema_same_) {
-      TupleTransfer(table_schema, schema_, p_row, row);
+      view.GetRow(column_indexes_, row);
     } else {
-      *row = *p_row;
+      view.GetRow(row);
     }
-    iterator_++;
+    ++iterator_;
     return true;
   }
   return false;
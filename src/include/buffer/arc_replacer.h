@@ -0,0 +1,102 @@
+#ifndef MINISQL_ARC_REPLACER_H
+#define MINISQL_ARC_REPLACER_H
+
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy.
+ *
+ * Resident pages are split into T1, pages referenced once since they were read, and T2, pages referenced again. Both
+ * are managed as LRU. Pages evicted from T1 are remembered in the ghost list B1, pages evicted from T2 in B2. A page
+ * read again while in B1 means T1 was too small, one in B2 means T2 was: the target size p of T1 moves accordingly,
+ * and the victim comes from T1 while it is larger than p. The policy therefore tunes itself between recency and
+ * frequency, and a scan only ever cycles through T1.
+ *
+ * References closer together than the correlated period (in ticks, one tick per Pin) count as one, like in
+ * LRUKReplacer, so a scan touching a page once per tuple does not promote it to T2.
+ *
+ * Only unpinned frames are candidates. Pinned frames still count towards the size of their list.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_pages the maximum number of pages the ARCReplacer will be required to store
+   * @param correlated_period a page referenced again within this many ticks stays in T1
+   */
+  explicit ARCReplacer(size_t num_pages, uint64_t correlated_period = LRUK_CORRELATED_PERIOD);
+
+  ~ARCReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  void SetFramePage(frame_id_t frame_id, page_tag_t page_tag) override;
+
+  void Resize(size_t num_pages) override;
+
+  /** @return the current target size of T1, only used for debug */
+  size_t GetTarget() const { return target_; }
+
+ private:
+  enum class List { kNone, kT1, kT2 };
+
+  struct FrameInfo {
+    page_tag_t page_tag_{INVALID_PAGE_ID};
+    List list_{List::kNone};
+    uint64_t key_{0};         // last reference
+    bool referenced_{false};  // the reference that loaded the page was seen
+    bool evictable_{false};
+  };
+
+  struct GhostList {
+    list<page_tag_t> order_;  // most recent first
+    unordered_map<page_tag_t, list<page_tag_t>::iterator> map_;
+  };
+
+  void Admit(frame_id_t frame_id, List list);
+
+  void MakeUnevictable(frame_id_t frame_id);
+
+  /** @return the list victims are taken from right now, null if there are none */
+  set<pair<uint64_t, frame_id_t>> *VictimList();
+
+  void Evict(frame_id_t frame_id);
+
+  static void Remember(GhostList &ghosts, page_tag_t page_tag);
+
+  static void Forget(GhostList &ghosts);
+
+  /** Keep T1 + B1 within the capacity and all four lists within twice of it. */
+  void TrimGhosts();
+
+  size_t capacity_;
+  uint64_t correlated_period_;
+  size_t target_{0};  // p, the size T1 is steered to
+  uint64_t current_tick_{0};
+  vector<FrameInfo> frames_;
+  size_t t1_size_{0};                   // frames in T1, pinned or not
+  size_t t2_size_{0};                   // frames in T2, pinned or not
+  set<pair<uint64_t, frame_id_t>> t1_;  // evictable frames of T1
+  set<pair<uint64_t, frame_id_t>> t2_;  // evictable frames of T2
+  GhostList b1_;
+  GhostList b2_;
+};
+
+#endif  // MINISQL_ARC_REPLACER_H
@@ -0,0 +1,42 @@
+#ifndef MINISQL_BUFFER_ACCESS_STRATEGY_H
+#define MINISQL_BUFFER_ACCESS_STRATEGY_H
+
+#include <vector>
+
+#include "common/config.h"
+
+using namespace std;
+
+class BufferPool;
+class BufferPoolManager;
+
+/**
+ * BufferAccessStrategy is a small private ring of frames for bulk reads such as sequential scans.
+ *
+ * A page fetched through the strategy that is not resident yet is loaded into the next frame of the ring instead of a
+ * frame taken from the replacer, recycling the page loaded there a lap ago. A full scan thus touches at most ring size
+ * frames of the pool and leaves the replacer order untouched. Pages that are already resident are used in place.
+ * When the strategy is destroyed its frames are handed back to the replacer with their pages.
+ */
+class BufferAccessStrategy {
+  friend class BufferPool;
+
+ public:
+  /**
+   * @param ring_size number of frames of the ring, split evenly over the shards of the pool and capped at half of the
+   *                  frames of a shard
+   */
+  explicit BufferAccessStrategy(BufferPoolManager *buffer_pool_manager, size_t ring_size = SCAN_RING_SIZE);
+
+  ~BufferAccessStrategy();
+
+  /** @return number of frames of the ring over all shards */
+  size_t GetRingSize() const;
+
+ private:
+  BufferPool *buffer_pool_;           // pool the frames of the ring are taken from
+  vector<vector<frame_id_t>> rings_;  // frames of each shard, INVALID_FRAME_ID until the slot is first used
+  vector<size_t> next_;               // next slot to recycle in each shard
+};
+
+#endif  // MINISQL_BUFFER_ACCESS_STRATEGY_H
@@ -0,0 +1,426 @@
+#ifndef MINISQL_BUFFER_POOL_H
+#define MINISQL_BUFFER_POOL_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/frame_arena.h"
+#include "buffer/page_table.h"
+#include "buffer/page_trace.h"
+#include "buffer/replacer.h"
+#include "page/page.h"
+#include "storage/disk_manager.h"
+#include "storage/extent_allocator.h"
+
+using namespace std;
+
+/**
+ * Counters of the pages of one type, see BufferPool::GetStats.
+ */
+struct PageTypeStats {
+  size_t hits_{0};             // fetches served from a resident page
+  size_t misses_{0};           // fetches of a page that was not resident
+  size_t evictions_{0};        // pages taken out of their frame for another page
+  size_t dirty_evictions_{0};  // evictions that had to write the page first
+  size_t write_backs_{0};      // writes of dirty pages, by evictions, the background writer, flushes or detaching
+  size_t pin_waits_{0};        // times a fetch waited for a write of the page it wanted
+
+  PageTypeStats &operator+=(const PageTypeStats &other);
+};
+
+/**
+ * State of one shard, see BufferPool::GetStats.
+ */
+struct ShardStats {
+  size_t frames_{0};            // frames of the shard
+  size_t free_frames_{0};       // length of the free list
+  size_t replacer_size_{0};     // unpinned frames the replacer can pick a victim from
+  size_t prefetches_{0};        // pages read ahead by the I/O threads
+  size_t compressed_pages_{0};  // pages held by the compressed cache
+  size_t compressed_bytes_{0};  // their compressed size
+  size_t compressed_hits_{0};   // pages read from the compressed cache instead of the disk
+  array<PageTypeStats, NUM_PAGE_TYPES> page_types_;
+
+  /** @return counters of all page types together */
+  PageTypeStats Total() const;
+};
+
+/**
+ * Snapshot of the counters and occupancy of a buffer pool. The counters only grow, the difference of two snapshots
+ * gives the activity in between.
+ */
+struct BufferPoolStats {
+  size_t pool_size_{0};
+  size_t max_pool_size_{0};
+  size_t compressed_cache_size_{0};
+  vector<ShardStats> shards_;
+
+  /** @return counters of the pages of one type in all shards */
+  PageTypeStats Total(PageType page_type) const;
+
+  /** @return counters of all pages in all shards */
+  PageTypeStats Total() const;
+};
+
+/**
+ * BufferPool caches the pages of any number of database files in one set of frames.
+ *
+ * A file is attached to the pool once and gets a file id, every resident page is tagged with the file id and its page
+ * id, so the pages of all files compete for the same frames and memory follows the pages in use rather than the
+ * number of files. Callers do not use the pool directly but through a BufferPoolManager, the handle of one file.
+ *
+ * The frames are partitioned into shards, a page always lives in shard ((page_id + file_id) % num_shards). Every shard
+ * owns its frames, page table, free list, replacer and latch, so threads touching pages of different shards never
+ * contend.
+ *
+ * An optional background writer cleans dirty unpinned frames ahead of eviction, and the replacers are asked for a
+ * clean victim first, so a miss rarely has to write a page before it can read one.
+ *
+ * Pages can also be requested ahead of time with PrefetchPage. A few I/O threads, started on the first request, read
+ * them into unpinned frames so that the later FetchPage is a hit.
+ *
+ * Every shard counts hits, misses, evictions, write-backs and waits per page type, the type the owner of a page tagged
+ * it with. A fetch is counted once the page is unpinned, so a page read from disk has been tagged by then.
+ *
+ * The operations on the pages can be recorded to a trace file, to replay them offline against other replacement
+ * policies and pool sizes. Tracing costs one atomic load per operation while it is off.
+ *
+ * Optionally, clean pages leaving their frame are kept compressed in RAM by a CompressedPageCache of their shard, and
+ * a page that is not resident is looked up there before it is read from disk.
+ *
+ * The pool can be resized while it is in use. Every shard reserves the address space of the frames it may grow to,
+ * so growing only appends frames, and shrinking evicts the frames at the end of every shard.
+ */
+class BufferPool {
+ public:
+  /**
+   * @param replacer_type replacement policy of every shard
+   * @param num_shards number of partitions, 0 picks one from the pool size
+   */
+  explicit BufferPool(size_t pool_size, ReplacerType replacer_type = ReplacerType::kLRU, size_t num_shards = 0);
+
+  /**
+   * Every file is expected to be detached already.
+   */
+  ~BufferPool();
+
+  DISALLOW_COPY(BufferPool)
+
+  /**
+   * Make the pages of a file cacheable by the pool.
+   * @return the id the pages of the file are tagged with
+   */
+  file_id_t AttachFile(DiskManager *disk_manager);
+
+  /**
+   * Write the dirty pages of a file and drop all of its pages from the pool. The file id may be handed out again.
+   * No page of the file may be pinned.
+   */
+  void DetachFile(file_id_t file_id);
+
+  /**
+   * Pin a page, reading it from disk if it is not resident.
+   * @param strategy if not null, a page that has to be read goes to a frame of this ring instead of a replacer victim
+   */
+  Page *FetchPage(file_id_t file_id, page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+  bool UnpinPage(file_id_t file_id, page_id_t page_id, bool is_dirty);
+
+  /**
+   * Ask the I/O threads to read a page that is going to be fetched soon. Returns at once, the request is only a hint
+   * and is dropped if the queue is full or no frame can be freed.
+   * @param strategy if not null, the page is read into a frame of this ring
+   */
+  void PrefetchPage(file_id_t file_id, page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Withdraw a read-ahead request still in the queue, e.g. for a page its iterator has passed already. Served late, it
+   * would read the page back after it was evicted and the replacer would take that for a second reference.
+   */
+  void DropPrefetch(file_id_t file_id, page_id_t page_id);
+
+  /**
+   * Copy a resident page without pinning it or counting an access.
+   * @return false if the page is not resident
+   */
+  bool PeekPage(file_id_t file_id, page_id_t page_id, char *data);
+
+  bool FlushPage(file_id_t file_id, page_id_t page_id);
+
+  /**
+   * Allocate a page in a file and pin it in a frame of its shard.
+   * Returns nullptr (and gives the page back) if every frame of that shard is pinned.
+   * @param extents if not null, the page is taken from the runs of this allocator instead of the first free one
+   * @param data_file data file of the tablespace the page is allocated in when there is no allocator
+   */
+  Page *NewPage(file_id_t file_id, page_id_t &page_id, ExtentAllocator *extents = nullptr, uint32_t data_file = 0);
+
+  bool DeletePage(file_id_t file_id, page_id_t page_id);
+
+  bool CheckAllUnpinned();
+
+  /**
+   * Only used for debug
+   * @return true if the page is currently held by a frame
+   */
+  bool IsResident(file_id_t file_id, page_id_t page_id);
+
+  /**
+   * Grow or shrink the pool to a new number of frames, split evenly over the shards as in the constructor.
+   * New frames go to the free lists. Frames past the new size of their shard are evicted, dirty ones written first;
+   * a pinned one is waited for, pages elsewhere stay usable meanwhile.
+   * @return false if the size is out of range, or a shard still had pinned frames to drop after
+   * POOL_RESIZE_TIMEOUT_MS, in which case that shard keeps its size
+   */
+  bool Resize(size_t pool_size);
+
+  size_t GetPoolSize() const { return pool_size_; }
+
+  /** @return number of frames the pool can be grown to */
+  size_t GetMaxPoolSize() const { return max_pool_size_; }
+
+  size_t GetNumShards() const { return shards_.size(); }
+
+  /**
+   * Set the memory of the compressed cache, split evenly over the shards. Shrinking it drops the oldest pages.
+   * @param size bytes of compressed pages, 0 disables the cache
+   */
+  void SetCompressedCacheSize(size_t size);
+
+  size_t GetCompressedCacheSize() const { return compressed_cache_size_; }
+
+  /**
+   * Start the background writer, it writes dirty unpinned frames every interval. Stopped by the destructor.
+   */
+  void StartFlusher(std::chrono::milliseconds interval = std::chrono::milliseconds(FLUSHER_INTERVAL_MS));
+
+  void StopFlusher();
+
+  /**
+   * Record every fetch, new page and unpin of every file to a trace file until StopTrace, see PageTraceWriter.
+   * A trace already being recorded is closed first.
+   * @return false if the trace file could not be created
+   */
+  bool StartTrace(const string &file_name);
+
+  /**
+   * Close the trace being recorded, if any.
+   * @return number of operations it recorded
+   */
+  size_t StopTrace();
+
+  /**
+   * Take a snapshot of the counters of every shard. The counters are read without latching, the free list and
+   * replacer sizes under the latch of their shard, one shard at a time.
+   */
+  BufferPoolStats GetStats();
+
+  /** @return number of fetches served from a resident page */
+  size_t GetHitCount() { return GetStats().Total().hits_; }
+
+  /** @return number of fetches that had to read the page from disk */
+  size_t GetMissCount() { return GetStats().Total().misses_; }
+
+  /** @return number of evictions that had to write the victim first */
+  size_t GetDirtyEvictionCount() { return GetStats().Total().dirty_evictions_; }
+
+  /** @return number of pages read by the I/O threads */
+  size_t GetPrefetchCount();
+
+ private:
+  // counters of the pages of one type in one shard, bumped under the shard latch but read without it
+  struct PageTypeCounters {
+    atomic<size_t> hits_{0};
+    atomic<size_t> misses_{0};
+    atomic<size_t> evictions_{0};
+    atomic<size_t> dirty_evictions_{0};
+    atomic<size_t> write_backs_{0};
+    atomic<size_t> pin_waits_{0};
+  };
+
+  // shards are hit by every thread, keep the latch of one off the cache lines of another
+  struct alignas(CACHE_LINE_SIZE) Shard {
+    Shard(size_t index, size_t size, size_t max_size, ReplacerType replacer_type);
+
+    size_t index_;                    // position in shards_
+    FrameArena arena_;                // data of the frames, aligned for direct I/O, room for max_size of them
+    deque<Page> pages_;               // frames indexed by shard-local frame id, appending never moves a page
+    size_t size_;                     // number of frames
+    PageTable page_table_;            // resident page tag -> local frame id
+    unique_ptr<Replacer> replacer_;   // to find an unpinned page for replacement
+    list<frame_id_t> free_list_;      // to find a free page for replacement
+    // ring each frame belongs to, frames of a ring stay out of the replacer
+    vector<const BufferAccessStrategy *> ring_owner_;
+    // pages with a write in flight and the number of writers, they are not read back before it is done
+    unordered_map<page_tag_t, int> writing_;
+    size_t flush_hand_{0};            // next frame the background writer looks at
+    mutex latch_;                     // protects everything above and the metadata of the frames
+    array<PageTypeCounters, NUM_PAGE_TYPES> counters_;  // indexed by page type
+    atomic<size_t> prefetch_count_{0};                  // pages read ahead by the I/O threads
+    CompressedPageCache compressed_;                    // clean pages evicted from the frames, under the latch
+    atomic<size_t> compressed_hits_{0};                 // pages read from compressed_
+    condition_variable io_cv_;        // signalled when a write of writing_ is done
+  };
+
+  struct PrefetchRequest {
+    file_id_t file_id_;
+    page_id_t page_id_;
+    BufferAccessStrategy *strategy_;
+  };
+
+  static page_tag_t TagOf(file_id_t file_id, page_id_t page_id) {
+    return static_cast<page_tag_t>(static_cast<uint64_t>(file_id) << 32 | static_cast<uint32_t>(page_id));
+  }
+
+  static page_tag_t TagOf(const Page &page) { return TagOf(page.file_id_, page.page_id_); }
+
+  void Trace(PageTraceOp op, file_id_t file_id, page_id_t page_id) {
+    PageTraceWriter *trace = trace_.load(std::memory_order_acquire);
+    if (trace != nullptr) {
+      trace->Record(op, file_id, page_id);
+    }
+  }
+
+  static PageTypeCounters &CountersOf(Shard &shard, const Page &page) {
+    return shard.counters_[static_cast<size_t>(page.page_type_)];
+  }
+
+  /**
+   * Reset the statistics metadata of a frame that is given a page. Caller holds the shard latch.
+   */
+  static void ResetPageType(Page &page) {
+    page.page_type_ = PageType::kUnknown;
+    page.miss_pending_ = false;
+    page.waits_pending_ = 0;
+  }
+
+  Shard &ShardOf(file_id_t file_id, page_id_t page_id) {
+    return *shards_[(static_cast<uint32_t>(page_id) + static_cast<uint32_t>(file_id)) % shards_.size()];
+  }
+
+  /**
+   * FetchPage without the trace record, it starts over here when the page showed up meanwhile.
+   */
+  Page *PinOrReadPage(file_id_t file_id, page_id_t page_id, BufferAccessStrategy *strategy);
+
+  /**
+   * Read a page that is not resident into a frame, from the compressed cache of the shard if it is there.
+   * Caller holds the shard latch.
+   */
+  void ReadPage(Shard &shard, file_id_t file_id, page_id_t page_id, char *data);
+
+  /**
+   * Take a frame from the free list or evict one, preferably clean, writing it back if dirty.
+   * Caller holds the shard latch through lock, it may be released while a write of the same page is in flight.
+   */
+  frame_id_t TryToFindFreePage(Shard &shard, unique_lock<mutex> &lock);
+
+  /**
+   * Take the next frame of the ring of a strategy, recycling the page it holds. Same locking as TryToFindFreePage.
+   */
+  frame_id_t TryToFindRingPage(Shard &shard, unique_lock<mutex> &lock, BufferAccessStrategy &strategy);
+
+  /**
+   * Write a page whose frame was just taken out of the page table, after any write of it already in flight.
+   */
+  void WriteBack(Shard &shard, unique_lock<mutex> &lock, const Page &page);
+
+  /**
+   * Copy up to max_pages dirty unpinned frames of a shard under its latch and write the copies without it, all of
+   * them in flight at once.
+   * @return number of pages written
+   */
+  size_t FlushDirtyFrames(Shard &shard, char *buffer, size_t max_pages);
+
+  /**
+   * Append frames to a shard and put them on its free list. Caller holds the shard latch.
+   */
+  void GrowShard(Shard &shard, size_t size);
+
+  /**
+   * Drop the frames past size from a shard, waiting for pinned ones to be unpinned.
+   * @return false if some of them were still pinned after POOL_RESIZE_TIMEOUT_MS
+   */
+  bool ShrinkShard(Shard &shard, size_t size);
+
+  /**
+   * Evict the unpinned pages of the frames past size and take those frames off the free list. Same locking as
+   * TryToFindFreePage.
+   * @return true if all of them are empty now and no eviction is in flight on them
+   */
+  bool EvictTail(Shard &shard, unique_lock<mutex> &lock, size_t size);
+
+  /**
+   * Take a page out of its frame for good, the frame keeps its data. Caller holds the shard latch.
+   */
+  void DropPage(Shard &shard, frame_id_t frame_id);
+
+  /**
+   * Put a frame taken for a page that turned out to be resident already back on the free list.
+   */
+  void ReturnFrame(Shard &shard, frame_id_t frame_id);
+
+  void FlusherLoop(std::chrono::milliseconds interval);
+
+  void WakeFlusher();
+
+  void PrefetchLoop();
+
+  /**
+   * Read a page into an unpinned frame unless it is resident already.
+   */
+  void ReadAhead(file_id_t file_id, page_id_t page_id, BufferAccessStrategy *strategy);
+
+  /**
+   * Drop the queued read-ahead requests matching a predicate and wait for the ones being served.
+   */
+  template <typename Predicate>
+  void CancelPrefetches(Predicate matches);
+
+  /**
+   * Hand the frames of a strategy back to the replacers, called when the strategy is destroyed.
+   */
+  void ReleaseAccessStrategy(BufferAccessStrategy *strategy);
+
+  friend class BufferAccessStrategy;
+
+ private:
+  atomic<size_t> pool_size_;          // number of pages in buffer pool
+  atomic<size_t> compressed_cache_size_{0};  // bytes the compressed caches of all shards may hold
+  size_t max_pool_size_;              // number of pages the shards have room for
+  mutex resize_latch_;                // one resize at a time
+  vector<unique_ptr<Shard>> shards_;  // latch partitions of the pool
+  // disk manager of every attached file, indexed by file id; only read for files with pages in the pool
+  vector<DiskManager *> files_;
+  mutex files_latch_;                 // protects attaching and detaching files
+  thread flusher_;                    // background writer, not joinable if it was never started
+  mutex flusher_latch_;               // protects the two flags below
+  condition_variable flusher_cv_;
+  bool flusher_stop_{false};
+  bool flusher_wakeup_{false};
+  vector<thread> io_threads_;         // read-ahead threads, started by the first request
+  mutex prefetch_latch_;              // protects the queues and the stop flag
+  condition_variable prefetch_cv_;    // signalled when a request is queued or done
+  deque<PrefetchRequest> prefetch_queue_;
+  // requests being served by the I/O threads, their file and strategy are not released before they are done
+  list<PrefetchRequest> prefetch_serving_;
+  bool prefetch_stop_{false};
+  // trace being recorded, null when tracing is off
+  atomic<PageTraceWriter *> trace_{nullptr};
+  // every trace recorded so far, a closed one is kept until the pool goes away in case an operation still holds it
+  vector<unique_ptr<PageTraceWriter>> traces_;
+  mutex trace_latch_;                 // protects starting and stopping traces
+};
+
+#endif  // MINISQL_BUFFER_POOL_H
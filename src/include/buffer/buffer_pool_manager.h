@@ -1,58 +1,174 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
-#include <list>
-#include <mutex>
-#include <unordered_map>
+#include <chrono>
+#include <memory>
 
-#include "buffer/lru_replacer.h"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool.h"
+#include "buffer/replacer.h"
 #include "page/disk_file_meta_page.h"
 #include "page/page.h"
 #include "storage/disk_manager.h"
 
 using namespace std;
 
+/**
+ * BufferPoolManager caches the pages of one database file.
+ *
+ * The frames belong to a BufferPool, which either is private to this file or is shared with the files of other
+ * databases. Page ids passed to the manager are those of its file, the manager tags them with the file id it got when
+ * the file was attached to the pool.
+ *
+ * Sizes, counters, the background writer and resizing are those of the pool, whether it is shared or not.
+ */
 class BufferPoolManager {
  public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  /**
+   * Cache the file in a pool of its own.
+   * @param replacer_type replacement policy of every shard
+   * @param num_shards number of partitions, 0 picks one from the pool size
+   */
+  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager,
+                             ReplacerType replacer_type = ReplacerType::kLRU, size_t num_shards = 0);
 
+  /**
+   * Cache the file in a pool shared with other files.
+   */
+  BufferPoolManager(shared_ptr<BufferPool> buffer_pool, DiskManager *disk_manager);
+
+  /**
+   * Write the dirty pages of the file and drop its pages from the pool.
+   */
   ~BufferPoolManager();
 
-  Page *FetchPage(page_id_t page_id);
+  /**
+   * Pin a page, reading it from disk if it is not resident.
+   * @param strategy if not null, a page that has to be read goes to a frame of this ring instead of a replacer victim
+   */
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) {
+    return buffer_pool_->FetchPage(file_id_, page_id, strategy);
+  }
 
-  bool UnpinPage(page_id_t page_id, bool is_dirty);
+  bool UnpinPage(page_id_t page_id, bool is_dirty) { return buffer_pool_->UnpinPage(file_id_, page_id, is_dirty); }
 
-  bool FlushPage(page_id_t page_id);
+  /**
+   * Ask the I/O threads to read a page that is going to be fetched soon. Returns at once, the request is only a hint
+   * and is dropped if the queue is full or no frame can be freed.
+   * @param strategy if not null, the page is read into a frame of this ring
+   */
+  void PrefetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) {
+    buffer_pool_->PrefetchPage(file_id_, page_id, strategy);
+  }
 
-  Page *NewPage(page_id_t &page_id);
+  /**
+   * Withdraw a read-ahead request still in the queue.
+   */
+  void DropPrefetch(page_id_t page_id) { buffer_pool_->DropPrefetch(file_id_, page_id); }
 
-  bool DeletePage(page_id_t page_id);
+  /**
+   * Copy a resident page without pinning it or counting an access.
+   * @return false if the page is not resident
+   */
+  bool PeekPage(page_id_t page_id, char *data) { return buffer_pool_->PeekPage(file_id_, page_id, data); }
 
-  bool IsPageFree(page_id_t page_id);
+  bool FlushPage(page_id_t page_id) { return buffer_pool_->FlushPage(file_id_, page_id); }
 
-  bool CheckAllUnpinned();
+  /**
+   * Allocate a page on disk and pin it in a frame of its shard.
+   * Returns nullptr (and gives the page back) if every frame of that shard is pinned.
+   * @param extents if not null, the page comes from the contiguous runs of this allocator, see ExtentAllocator
+   */
+  Page *NewPage(page_id_t &page_id, ExtentAllocator *extents = nullptr) {
+    return buffer_pool_->NewPage(file_id_, page_id, extents);
+  }
+
+  /**
+   * Allocate a page in a data file of the tablespace and pin it, see DiskManager::AddDataFile.
+   */
+  Page *NewPage(page_id_t &page_id, uint32_t data_file) {
+    return buffer_pool_->NewPage(file_id_, page_id, nullptr, data_file);
+  }
+
+  /**
+   * Give back the pages an allocator reserved in this file but did not hand out, called by its owner on destruction.
+   */
+  void ReleaseExtents(ExtentAllocator &extents) { extents.Release(disk_manager_); }
+
+  bool DeletePage(page_id_t page_id) { return buffer_pool_->DeletePage(file_id_, page_id); }
+
+  bool IsPageFree(page_id_t page_id) { return disk_manager_->IsPageFree(page_id); }
 
- private:
   /**
-   * Allocate new page (operations like create index/table) For now just keep an increasing counter
+   * Give the free pages at the end of the file back to the file system, see DiskManager::Truncate.
+   * @return number of pages the file lost
    */
-  page_id_t AllocatePage();
+  uint64_t TruncateFile() { return disk_manager_->Truncate(); }
 
   /**
-   * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
+   * @return number of pages the files of the database take on disk
    */
-  void DeallocatePage(page_id_t page_id);
+  uint64_t GetFilePages() const { return disk_manager_->GetFilePages(); }
+
+  bool CheckAllUnpinned() { return buffer_pool_->CheckAllUnpinned(); }
+
+  /**
+   * Only used for debug
+   * @return true if the page is currently held by a frame
+   */
+  bool IsResident(page_id_t page_id) { return buffer_pool_->IsResident(file_id_, page_id); }
+
+  /**
+   * Grow or shrink the pool, see BufferPool::Resize.
+   */
+  bool Resize(size_t pool_size) { return buffer_pool_->Resize(pool_size); }
+
+  size_t GetPoolSize() const { return buffer_pool_->GetPoolSize(); }
+
+  /** @return number of frames the pool can be grown to */
+  size_t GetMaxPoolSize() const { return buffer_pool_->GetMaxPoolSize(); }
+
+  size_t GetNumShards() const { return buffer_pool_->GetNumShards(); }
+
+  BufferPool *GetBufferPool() const { return buffer_pool_.get(); }
+
+  file_id_t GetFileId() const { return file_id_; }
+
+  /**
+   * Start the background writer of the pool, it writes dirty unpinned frames every interval.
+   */
+  void StartFlusher(std::chrono::milliseconds interval = std::chrono::milliseconds(FLUSHER_INTERVAL_MS)) {
+    buffer_pool_->StartFlusher(interval);
+  }
+
+  void StopFlusher() { buffer_pool_->StopFlusher(); }
+
+  /**
+   * Record the page operations of the pool to a trace file, see BufferPool::StartTrace.
+   */
+  bool StartTrace(const string &file_name) { return buffer_pool_->StartTrace(file_name); }
+
+  size_t StopTrace() { return buffer_pool_->StopTrace(); }
+
+  /** Snapshot of the counters of the pool, see BufferPool::GetStats. */
+  BufferPoolStats GetStats() { return buffer_pool_->GetStats(); }
+
+  /** @return number of fetches served from a resident page */
+  size_t GetHitCount() { return buffer_pool_->GetHitCount(); }
+
+  /** @return number of fetches that had to read the page from disk */
+  size_t GetMissCount() { return buffer_pool_->GetMissCount(); }
+
+  /** @return number of evictions that had to write the victim first */
+  size_t GetDirtyEvictionCount() { return buffer_pool_->GetDirtyEvictionCount(); }
 
-  frame_id_t TryToFindFreePage();
+  /** @return number of pages read by the I/O threads */
+  size_t GetPrefetchCount() { return buffer_pool_->GetPrefetchCount(); }
 
  private:
-  size_t pool_size_;                                 // number of pages in buffer pool
-  Page *pages_;                                      // array of pages
-  DiskManager *disk_manager_;                        // pointer to the disk manager.
-  unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
-  Replacer *replacer_;                               // to find an unpinned page for replacement
-  list<frame_id_t> free_list_;                       // to find a free page for replacement
-  recursive_mutex latch_;                            // to protect shared data structure
+  shared_ptr<BufferPool> buffer_pool_;  // frames of this file, maybe of others as well
+  DiskManager *disk_manager_;           // pointer to the disk manager.
+  file_id_t file_id_;                   // tag of the pages of this file in the pool
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
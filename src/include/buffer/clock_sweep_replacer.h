@@ -0,0 +1,66 @@
+#ifndef MINISQL_CLOCK_SWEEP_REPLACER_H
+#define MINISQL_CLOCK_SWEEP_REPLACER_H
+
+#include <atomic>
+#include <memory>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * ClockSweepReplacer implements the clock sweep of PostgreSQL on a flat array of per-frame state words.
+ *
+ * The state of a frame is one atomic word holding an evictable bit and a usage count. Pin clears the bit and bumps the
+ * count up to CLOCK_SWEEP_MAX_USAGE, Unpin sets the bit, both with a single compare-and-swap when uncontended. Victim
+ * advances an atomic clock hand over the array: an evictable frame with a non-zero count has it decremented and is
+ * passed, the first one at zero is claimed. Frames referenced often survive several rounds of the hand.
+ *
+ * Unlike the other replacers no method takes a latch, so it can be shared by threads without an outer one. Only
+ * Resize must not run concurrently with the other methods.
+ */
+class ClockSweepReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ClockSweepReplacer.
+   * @param num_pages the maximum number of pages the ClockSweepReplacer will be required to store
+   */
+  explicit ClockSweepReplacer(size_t num_pages);
+
+  ~ClockSweepReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  void SetFramePage(frame_id_t frame_id, page_tag_t page_tag) override;
+
+  void Resize(size_t num_pages) override;
+
+  /** @return the usage count of a frame, only used for debug */
+  uint32_t GetUsageCount(frame_id_t frame_id) const { return states_[frame_id].load() & USAGE_MASK; }
+
+ private:
+  static constexpr uint32_t EVICTABLE = 1U << 31;
+  static constexpr uint32_t USAGE_MASK = 0xff;
+
+  /**
+   * Sweep the clock hand until an evictable frame with a usage count of zero is claimed.
+   * @param skip_left frames at zero that may still be passed because prefer rejects them
+   */
+  bool Sweep(frame_id_t *frame_id, const std::function<bool(frame_id_t)> *prefer, int skip_left);
+
+  size_t num_frames_;
+  unique_ptr<atomic<uint32_t>[]> states_;
+  atomic<size_t> hand_{0};
+  atomic<size_t> size_{0};  // frames with the evictable bit set
+};
+
+#endif  // MINISQL_CLOCK_SWEEP_REPLACER_H
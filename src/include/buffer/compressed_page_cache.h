@@ -0,0 +1,75 @@
+#ifndef MINISQL_COMPRESSED_PAGE_CACHE_H
+#define MINISQL_COMPRESSED_PAGE_CACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * CompressedPageCache keeps clean pages evicted from a buffer pool compressed with LZCodec, as a second tier between
+ * the frames and the disk.
+ *
+ * It is exclusive: a page taken back into a frame leaves the cache, so a page is in at most one of the two tiers and
+ * its copy here is always the one on disk. Pages that compress to more than COMPRESSED_PAGE_MAX_SIZE are not kept.
+ * When the compressed data would exceed the capacity, the least recently inserted pages are dropped.
+ *
+ * It does no latching, every shard of the pool owns one and uses it under its latch.
+ */
+class CompressedPageCache {
+ public:
+  /**
+   * @param capacity bytes of compressed data the cache may hold, 0 disables it
+   */
+  explicit CompressedPageCache(size_t capacity = 0);
+
+  /**
+   * Compress a page and keep it, replacing an older copy.
+   * @return false if the cache is disabled or the page does not compress well enough
+   */
+  bool Insert(page_tag_t page_tag, const char *data);
+
+  /**
+   * Decompress a page into a frame and drop it from the cache.
+   * @return false if the page is not cached
+   */
+  bool Take(page_tag_t page_tag, char *data);
+
+  /** Forget a page, called when it is allocated or deallocated on disk. */
+  void Erase(page_tag_t page_tag);
+
+  /** Forget every page of a file, called when the file is detached and its id may be handed out again. */
+  void EraseFile(file_id_t file_id);
+
+  /** Change the capacity, dropping pages until the cache fits. */
+  void SetCapacity(size_t capacity);
+
+  size_t GetCapacity() const { return capacity_; }
+
+  /** @return bytes of compressed data held */
+  size_t GetSize() const { return size_; }
+
+  /** @return number of pages held */
+  size_t GetPageCount() const { return index_.size(); }
+
+ private:
+  struct Entry {
+    page_tag_t page_tag_;
+    vector<char> data_;
+  };
+
+  void EraseEntry(list<Entry>::iterator it);
+
+  void Trim();
+
+  size_t capacity_;
+  size_t size_{0};
+  list<Entry> entries_;  // most recently inserted first
+  unordered_map<page_tag_t, list<Entry>::iterator> index_;
+  vector<char> buffer_;  // output of the codec before it is known to be worth keeping
+};
+
+#endif  // MINISQL_COMPRESSED_PAGE_CACHE_H
@@ -0,0 +1,44 @@
+#ifndef MINISQL_FRAME_ARENA_H
+#define MINISQL_FRAME_ARENA_H
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * FrameArena is one zeroed allocation holding the data of a number of frames back to back. Every frame starts on a
+ * PAGE_SIZE boundary, which is what direct I/O asks of its buffers, so pages are read from disk straight into frames.
+ *
+ * The arena is a private anonymous mapping. An arena of at least HUGE_PAGE_SIZE is aligned to it and advised to use
+ * transparent huge pages, so a large pool is covered by a few TLB entries instead of one per frame.
+ *
+ * The mapping only reserves address space: memory is committed as frames are first touched, and Release hands the
+ * memory of frames no longer used back to the kernel. A buffer pool reserves room for the frames it may grow to.
+ */
+class FrameArena {
+ public:
+  explicit FrameArena(size_t num_frames);
+
+  ~FrameArena();
+
+  DISALLOW_COPY(FrameArena)
+
+  /** @return the data of a frame, PAGE_SIZE bytes aligned to PAGE_SIZE */
+  inline char *GetFrame(size_t frame_id) { return data_ + frame_id * PAGE_SIZE; }
+
+  inline size_t GetNumFrames() const { return num_frames_; }
+
+  /**
+   * Give the memory of some frames back to the kernel. They stay usable and read as zeroes when touched again.
+   */
+  void Release(size_t first_frame_id, size_t num_frames);
+
+ private:
+  size_t num_frames_;
+  char *data_;
+  void *mapping_;       // start of the mapping, data_ may be further to meet the alignment
+  size_t mapping_size_;
+};
+
+#endif  // MINISQL_FRAME_ARENA_H
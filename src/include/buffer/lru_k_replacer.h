@@ -0,0 +1,84 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <deque>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The victim is the frame whose K-th most recent reference is the oldest. Frames with fewer than K references have an
+ * infinite backward K-distance and go first, ordered by their last reference. References closer together than the
+ * correlated period (in ticks, one tick per Pin) count as one, so a scan touching a page once per tuple still leaves
+ * it with a single reference. The history of evicted pages is kept for a while so a page read again soon after its
+ * eviction does not start over.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k number of references remembered per page
+   * @param correlated_period references of a page at most this many ticks apart are merged
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_DEFAULT_K,
+                        uint64_t correlated_period = LRUK_CORRELATED_PERIOD);
+
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  void SetFramePage(frame_id_t frame_id, page_tag_t page_tag) override;
+
+  void Resize(size_t num_pages) override;
+
+ private:
+  struct History {
+    deque<uint64_t> refs_;  // uncorrelated references, most recent first, at most k
+    uint64_t last_{0};      // last reference, correlated or not
+  };
+
+  struct FrameInfo {
+    page_tag_t page_tag_{INVALID_PAGE_ID};
+    History history_;
+    bool evictable_{false};
+    pair<uint64_t, frame_id_t> key_;  // position in cold_ or hot_ while evictable
+  };
+
+  void RecordAccess(FrameInfo &frame);
+
+  void MakeEvictable(frame_id_t frame_id);
+
+  void MakeUnevictable(frame_id_t frame_id);
+
+  void Evict(frame_id_t frame_id);
+
+  size_t k_;
+  uint64_t correlated_period_;
+  uint64_t current_tick_{0};
+  vector<FrameInfo> frames_;
+  set<pair<uint64_t, frame_id_t>> cold_;  // evictable frames with less than k references, by last reference
+  set<pair<uint64_t, frame_id_t>> hot_;   // evictable frames with k references, by k-th most recent reference
+  size_t retain_capacity_;           // histories of evicted pages kept at most
+  list<page_tag_t> retained_order_;  // evicted pages, most recent first
+  unordered_map<page_tag_t, pair<History, list<page_tag_t>::iterator>> retained_;
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
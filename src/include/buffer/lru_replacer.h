@@ -30,6 +30,8 @@ class LRUReplacer : public Replacer {
 
   bool Victim(frame_id_t *frame_id) override;
 
+  bool PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) override;
+
   void Pin(frame_id_t frame_id) override;
 
   void Unpin(frame_id_t frame_id) override;
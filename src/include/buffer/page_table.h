@@ -0,0 +1,61 @@
+#ifndef MINISQL_PAGE_TABLE_H
+#define MINISQL_PAGE_TABLE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * PageTable maps the tags of resident pages to the frames holding them.
+ *
+ * It is a flat open-addressing hash table with linear probing. Deletion shifts the following entries of the probe
+ * run back instead of leaving tombstones, so lookups never degrade after many evictions. The table does not grow on
+ * its own: it is sized for the number of frames it has to index, kept at most half full, and only rebuilt by Resize
+ * when that number changes.
+ */
+class PageTable {
+ public:
+  /**
+   * @param num_frames the maximum number of pages that will be resident at the same time
+   */
+  explicit PageTable(size_t num_frames);
+
+  /**
+   * @param[out] frame_id frame holding the page, untouched if the page is not resident
+   * @return true if the page is resident
+   */
+  bool Find(page_tag_t page_tag, frame_id_t *frame_id) const;
+
+  /**
+   * Insert a mapping, or overwrite the frame of an existing one.
+   */
+  void Insert(page_tag_t page_tag, frame_id_t frame_id);
+
+  /**
+   * @return true if the mapping existed and was removed
+   */
+  bool Erase(page_tag_t page_tag);
+
+  size_t Size() const { return size_; }
+
+  /**
+   * Rehash the mappings into a table sized for a new number of frames, which must not be less than Size().
+   */
+  void Resize(size_t num_frames);
+
+ private:
+  struct Slot {
+    page_tag_t page_tag_{INVALID_PAGE_ID};
+    frame_id_t frame_id_{INVALID_FRAME_ID};
+  };
+
+  size_t Home(page_tag_t page_tag) const;
+
+  std::vector<Slot> slots_;
+  size_t mask_;
+  uint32_t shift_;  // 64 - log2(capacity)
+  size_t size_{0};
+};
+
+#endif  // MINISQL_PAGE_TABLE_H
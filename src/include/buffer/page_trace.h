@@ -0,0 +1,124 @@
+#ifndef MINISQL_PAGE_TRACE_H
+#define MINISQL_PAGE_TRACE_H
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+using namespace std;
+
+/** First bytes of a trace file. */
+static constexpr char PAGE_TRACE_MAGIC[] = "MSQLTRC1";
+static constexpr size_t PAGE_TRACE_MAGIC_SIZE = sizeof(PAGE_TRACE_MAGIC) - 1;
+
+/**
+ * Buffer pool operations a page trace records.
+ */
+enum class PageTraceOp : uint8_t { kFetch = 0, kNew, kUnpin };
+
+/**
+ * One operation of a page trace, as it is stored in the trace file.
+ */
+struct PageTraceRecord {
+  uint64_t timestamp_;  // nanoseconds since the trace was started
+  file_id_t file_id_;   // file of the page in the buffer pool
+  page_id_t page_id_;
+  uint32_t thread_;     // small number of the thread, in the order threads first recorded
+  PageTraceOp op_;
+  uint8_t reserved_[3]{0, 0, 0};
+};
+
+static_assert(sizeof(PageTraceRecord) == 24, "Page trace records are stored as they are.");
+
+/**
+ * PageTraceWriter appends the page accesses of a buffer pool to a trace file.
+ *
+ * The file starts with PAGE_TRACE_MAGIC followed by fixed size records. Records are collected in memory under a latch
+ * and written PAGE_TRACE_BUFFER_RECORDS at a time, or when the writer is closed.
+ */
+class PageTraceWriter {
+ public:
+  explicit PageTraceWriter(const string &file_name);
+
+  ~PageTraceWriter();
+
+  DISALLOW_COPY(PageTraceWriter)
+
+  /** @return false if the file could not be created */
+  bool IsOpen() const { return is_open_; }
+
+  /**
+   * Append an operation. Does nothing once the writer is closed.
+   */
+  void Record(PageTraceOp op, file_id_t file_id, page_id_t page_id);
+
+  /**
+   * Write the pending records and close the file.
+   */
+  void Close();
+
+  /** @return number of records appended */
+  size_t GetRecordCount();
+
+ private:
+  void Flush();
+
+  mutex latch_;  // protects everything below
+  ofstream file_;
+  bool is_open_{false};
+  vector<PageTraceRecord> buffer_;
+  size_t record_count_{0};
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * PageTraceReader reads the records of a trace file written by PageTraceWriter.
+ */
+class PageTraceReader {
+ public:
+  explicit PageTraceReader(const string &file_name);
+
+  /** @return false if the file could not be opened or is not a page trace */
+  bool IsOpen() const { return is_open_; }
+
+  /**
+   * Read the next record.
+   * @return false at the end of the trace
+   */
+  bool Next(PageTraceRecord *record);
+
+ private:
+  ifstream file_;
+  bool is_open_{false};
+};
+
+/**
+ * Outcome of replaying a trace, see SimulateTrace.
+ */
+struct TraceSimulation {
+  size_t hits_{0};         // fetches of a resident page
+  size_t misses_{0};       // fetches that would have read the page
+  size_t new_pages_{0};    // pages allocated, they take a frame but read nothing
+  size_t evictions_{0};    // pages evicted to make room
+  size_t no_victims_{0};   // operations that found every frame pinned, their page is skipped
+
+  /** @return hits over fetches, 0 if there were none */
+  double HitRatio() const {
+    size_t fetches = hits_ + misses_;
+    return fetches == 0 ? 0 : static_cast<double>(hits_) / fetches;
+  }
+};
+
+/**
+ * Replay recorded operations against a replacement policy in a pool of the given number of frames, in one piece.
+ * Only the frame assignments are simulated, no page is read or written.
+ */
+TraceSimulation SimulateTrace(const vector<PageTraceRecord> &records, ReplacerType replacer_type, size_t pool_size);
+
+#endif  // MINISQL_PAGE_TRACE_H
@@ -0,0 +1,48 @@
+#ifndef MINISQL_READ_AHEAD_WINDOW_H
+#define MINISQL_READ_AHEAD_WINDOW_H
+
+#include <deque>
+
+#include "buffer/buffer_access_strategy.h"
+#include "common/config.h"
+#include "page/page.h"
+
+using namespace std;
+
+class BufferPoolManager;
+
+/**
+ * ReadAheadWindow keeps the read-ahead requests of an iterator that walks a chain of pages, such as the pages of a
+ * table heap or the leaves of a B+ tree, a fixed distance ahead of it.
+ *
+ * Only the next page id of a page in memory is known, so the window grows one page at a time: when the iterator
+ * enters a page, the last requested page is looked at if the I/O threads have read it already, and its successor is
+ * requested in turn. A window without a buffer pool manager or with distance 0 does nothing.
+ */
+class ReadAheadWindow {
+ public:
+  /** Read the next page id out of a copy of a page of the chain. */
+  using NextPageFunc = page_id_t (*)(Page *page);
+
+  /**
+   * @param distance number of pages requested ahead of the iterator, 0 turns read-ahead off
+   * @param strategy ring the pages are read into, may be null, the distance is capped at half of its frames
+   */
+  ReadAheadWindow(BufferPoolManager *buffer_pool_manager, NextPageFunc next_page_of, int distance = PREFETCH_DISTANCE,
+                  BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Tell the window the iterator entered a page and request whatever is missing ahead of it.
+   * The page has to be resident, the iterator has just read it.
+   */
+  void Advance(page_id_t page_id);
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  NextPageFunc next_page_of_;
+  size_t distance_;
+  BufferAccessStrategy *strategy_;
+  deque<page_id_t> requested_;  // pages requested ahead of the iterator, in chain order
+};
+
+#endif  // MINISQL_READ_AHEAD_WINDOW_H
@@ -2,9 +2,16 @@
 #define MINISQL_REPLACER_H
 
 #include <cstdio>
+#include <functional>
+#include <memory>
 
 #include "common/config.h"
 
+/**
+ * Page replacement policies a buffer pool can be configured with.
+ */
+enum class ReplacerType { kLRU, kClock, kLRUK, kTwoQueue, kARC, kClockSweep };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -14,6 +21,12 @@ class Replacer {
 
   virtual ~Replacer() = default;
 
+  /**
+   * Create a replacer of a policy with its default parameters.
+   * @param num_pages the maximum number of pages the replacer will be required to store
+   */
+  static std::unique_ptr<Replacer> Create(ReplacerType replacer_type, size_t num_pages);
+
   /**
    * Remove the victim frame as defined by the replacement policy.
    * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
@@ -21,6 +34,18 @@ class Replacer {
    */
   virtual bool Victim(frame_id_t *frame_id) = 0;
 
+  /**
+   * Like Victim, but among the first VICTIM_SEARCH_DEPTH frames in eviction order take the first one accepted by
+   * prefer. Falls back to the plain victim if none of them is.
+   * @param[out] frame_id id of frame that was removed
+   * @param prefer predicate on frames, e.g. whether the page of the frame is clean
+   * @return true if a victim frame was found, false otherwise
+   */
+  virtual bool PreferredVictim(frame_id_t *frame_id,
+                               __attribute__((unused)) const std::function<bool(frame_id_t)> &prefer) {
+    return Victim(frame_id);
+  }
+
   /**
    * Pins a frame, indicating that it should not be victimized until it is unpinned.
    * @param frame_id the id of the frame to pin
@@ -35,6 +60,22 @@ class Replacer {
 
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
+
+  /**
+   * Tells the replacer which page a frame holds from now on, called before the first Pin of a freshly loaded page.
+   * Policies that remember pages beyond their residency (LRU-K, 2Q) need this, the others can ignore it.
+   * @param frame_id the id of the frame
+   * @param page_tag the page now in the frame with the file it belongs to, INVALID_PAGE_ID if the frame was emptied
+   */
+  virtual void SetFramePage(__attribute__((unused)) frame_id_t frame_id,
+                            __attribute__((unused)) page_tag_t page_tag) {}
+
+  /**
+   * Tells the replacer the number of frames changed. When it shrinks, the frames past the new number have been pinned
+   * and emptied with SetFramePage before. Policies keeping per-frame state resize it, the others can ignore this.
+   * @param num_pages the new number of frames
+   */
+  virtual void Resize(__attribute__((unused)) size_t num_pages) {}
 };
 
 #endif  // MINISQL_REPLACER_H
@@ -0,0 +1,77 @@
+#ifndef MINISQL_TWO_QUEUE_REPLACER_H
+#define MINISQL_TWO_QUEUE_REPLACER_H
+
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * TwoQueueReplacer implements the full 2Q replacement policy.
+ *
+ * A page read for the first time enters A1in, a FIFO that absorbs correlated references: hits there do not reorder
+ * anything. When A1in holds more than a quarter of the frames its oldest page is evicted and remembered in A1out, a
+ * queue of page ids only. A page read again while still in A1out has proven it is re-referenced and enters Am, which
+ * is managed as LRU. A sequential scan therefore only ever cycles through A1in.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQueueReplacer.
+   * @param num_pages the maximum number of pages the TwoQueueReplacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_pages);
+
+  ~TwoQueueReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool PreferredVictim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &prefer) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  void SetFramePage(frame_id_t frame_id, page_tag_t page_tag) override;
+
+  void Resize(size_t num_pages) override;
+
+ private:
+  enum class Queue { kNone, kA1in, kAm };
+
+  struct FrameInfo {
+    page_tag_t page_tag_{INVALID_PAGE_ID};
+    Queue queue_{Queue::kNone};
+    uint64_t key_{0};  // load order in A1in, last reference in Am
+    bool evictable_{false};
+  };
+
+  void Admit(frame_id_t frame_id, bool hot);
+
+  void MakeUnevictable(frame_id_t frame_id);
+
+  /** @return the queue victims are taken from right now, null if there are none */
+  set<pair<uint64_t, frame_id_t>> *VictimQueue();
+
+  void Evict(frame_id_t frame_id);
+
+  size_t kin_;
+  size_t kout_;
+  uint64_t current_tick_{0};
+  vector<FrameInfo> frames_;
+  size_t a1in_size_{0};                   // frames in A1in, pinned or not
+  set<pair<uint64_t, frame_id_t>> a1in_;  // evictable frames of A1in
+  set<pair<uint64_t, frame_id_t>> am_;    // evictable frames of Am
+  list<page_tag_t> a1out_;                // ghost entries, most recent first
+  unordered_map<page_tag_t, list<page_tag_t>::iterator> a1out_map_;
+};
+
+#endif  // MINISQL_TWO_QUEUE_REPLACER_H
@@ -76,15 +76,23 @@ class CatalogManager {
 
   ~CatalogManager();
 
-  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Txn *txn, TableInfo *&table_info);
+  /**
+   * @param data_file data file of the tablespace the table is placed in, its metadata page included
+   */
+  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Txn *txn, TableInfo *&table_info,
+                      uint32_t data_file = 0);
 
   dberr_t GetTable(const std::string &table_name, TableInfo *&table_info);
 
   dberr_t GetTables(std::vector<TableInfo *> &tables) const;
 
+  /**
+   * @param data_file data file of the tablespace the index is placed in, its metadata page included, which is how the
+   * placement of an index that has no node yet survives a restart
+   */
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
                       const std::vector<std::string> &index_keys, Txn *txn, IndexInfo *&index_info,
-                      const string &index_type);
+                      const string &index_type, uint32_t data_file = 0);
 
   dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
 
@@ -94,7 +102,26 @@ class CatalogManager {
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Compact the database file: rewrite every table densely from the front of its data file, rebuild its indexes on
+   * the new row ids, move the metadata pages down into free pages and cut the free pages at the end off the file.
+   * @param[out] released_pages number of pages the files lost
+   */
+  dberr_t Vacuum(Txn *txn, uint64_t &released_pages);
+
  private:
+  /**
+   * Copy the rows of a table into a new heap and its indexes into new trees, then swap the copies in and free the
+   * pages of the originals. Pages are allocated from the lowest free ones, so the copy fills the holes of the file.
+   * If a row or an index entry cannot be copied, the copies are freed and the table is left as it was.
+   */
+  dberr_t RebuildTable(TableInfo *table_info, Txn *txn);
+
+  /**
+   * Move metadata pages to the lowest free page of their data file when it is below them.
+   */
+  void RelocateMetaPages(std::map<uint32_t, page_id_t> &meta_pages);
+
   dberr_t DropTable(table_id_t table_id);
 
   dberr_t FlushCatalogMetaPage() const;
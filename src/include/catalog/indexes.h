@@ -63,7 +63,8 @@ class IndexInfo {
 /**
  * TODO: Student Implement
  */
-  void Init(IndexMetadata *meta_data, TableInfo *table_info, BufferPoolManager * buffer_pool_manager) {
+  void Init(IndexMetadata *meta_data, TableInfo *table_info, BufferPoolManager * buffer_pool_manager,
+            uint32_t data_file = 0) {
     // Step1: init index metadata and table info
     // Step2: mapping index key to key schema
     // Step3: call CreateIndex to create the index
@@ -71,11 +72,28 @@ class IndexInfo {
     meta_data_ = meta_data;
     //table_info_ = table_info;
     key_schema_ = Schema::ShallowCopySchema(table_info->GetSchema(),meta_data->key_map_);
-    index_ = CreateIndex(buffer_pool_manager,"bptree");
+    index_ = CreateIndex(buffer_pool_manager,"bptree",data_file,meta_data->GetIndexId());
   }
 
   inline Index *GetIndex() { return index_; }
 
+  /**
+   * Start an empty copy of the index to rebuild it into. The copy keeps its root in the index roots page under an id
+   * of its own, the index is left as it is until ReplaceIndex.
+   * @param shadow_id id no index uses
+   * @param data_file data file of the tablespace the pages of the copy are allocated in
+   */
+  Index *CreateShadowIndex(BufferPoolManager *buffer_pool_manager, index_id_t shadow_id, uint32_t data_file) {
+    return CreateIndex(buffer_pool_manager, "bptree", data_file, shadow_id);
+  }
+
+  /**
+   * Drop the pages of the index and put a copy made by CreateShadowIndex in its place, the copy object is deleted.
+   */
+  void ReplaceIndex(BufferPoolManager *buffer_pool_manager, Index *shadow, index_id_t shadow_id, uint32_t data_file);
+
+  index_id_t GetIndexId() const { return meta_data_->GetIndexId(); }
+
   std::string GetIndexName() { return meta_data_->GetIndexName(); }
 
   IndexSchema *GetIndexKeySchema() { return key_schema_; }
@@ -83,7 +101,12 @@ class IndexInfo {
  private:
   explicit IndexInfo() : meta_data_{nullptr}, index_{nullptr}, key_schema_{nullptr} {}
 
-  Index *CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type);
+  /**
+   * @param data_file data file of the tablespace the pages of the index are allocated in
+   * @param index_id id the root of the tree is kept under in the index roots page
+   */
+  Index *CreateIndex(BufferPoolManager *buffer_pool_manager, const string &index_type, uint32_t data_file,
+                     index_id_t index_id);
 
  private:
   IndexMetadata *meta_data_;
@@ -23,7 +23,7 @@ class TableMetadata {
    * will create new table schema and owned by mem heap
    */
   static TableMetadata *Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                               TableSchema *schema);
+                               TableSchema *schema, page_id_t fsm_page_id = INVALID_PAGE_ID);
 
   inline table_id_t GetTableId() const { return table_id_; }
 
@@ -33,17 +33,26 @@ class TableMetadata {
 
   inline Schema *GetSchema() const { return schema_; }
 
+  /** @return first page of the free-space map, INVALID_PAGE_ID for a table written before it had one */
+  inline page_id_t GetFreeSpaceMapPageId() const { return fsm_page_id_; }
+
+  inline void SetFreeSpaceMapPageId(page_id_t fsm_page_id) { fsm_page_id_ = fsm_page_id; }
+
  private:
   TableMetadata() = delete;
 
-  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema);
+  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                page_id_t fsm_page_id);
 
  private:
   static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  // marks the free-space map page id after the schema, metadata written before it ends with the schema
+  static constexpr uint32_t TABLE_METADATA_FSM_MAGIC_NUM = 344529;
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
   Schema *schema_;
+  page_id_t fsm_page_id_;
 };
 
 /**
@@ -65,6 +74,18 @@ class TableInfo {
 
   inline TableHeap *GetTableHeap() const { return table_heap_; }
 
+  inline TableMetadata *GetTableMeta() const { return table_meta_; }
+
+  /**
+   * Replace the heap of the table by a rebuilt one, the metadata follows its first page and its free-space map.
+   */
+  void ResetTableHeap(TableHeap *table_heap) {
+    delete table_heap_;
+    table_heap_ = table_heap;
+    table_meta_->root_page_id_ = table_heap->GetFirstPageId();
+    table_meta_->fsm_page_id_ = table_heap->GetFreeSpaceMapPageId();
+  }
+
   inline table_id_t GetTableId() const { return table_meta_->table_id_; }
 
   inline std::string GetTableName() const { return table_meta_->table_name_; }
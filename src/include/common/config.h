@@ -13,8 +13,34 @@ static constexpr int META_PAGE_ID = 0;          // physical page id of the disk
 static constexpr int CATALOG_META_PAGE_ID = 0;  // logical page id of the catalog meta data
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index roots
 
-static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
-static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr int PAGE_SIZE = 4096;                   // size of a data page in byte
+static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;   // default size of buffer pool
+static constexpr int CACHE_LINE_SIZE = 64;               // frame metadata and shards are padded to this
+static constexpr int HUGE_PAGE_SIZE = 2 * 1024 * 1024;   // frame arenas this large are backed by huge pages
+static constexpr int BUFFER_POOL_MAX_SHARDS = 16;        // upper bound of latch partitions of a buffer pool
+static constexpr int BUFFER_POOL_SHARD_MIN_FRAMES = 64;  // a buffer pool is split only if every shard gets this many
+static constexpr int BUFFER_POOL_MAX_SIZE = 262144;      // frames a buffer pool can be grown to at run time
+static constexpr int POOL_RESIZE_TIMEOUT_MS = 1000;      // a shrink gives up if frames stay pinned this long
+static constexpr int BUFFER_POOL_MAX_FILES = 1024;       // database files a buffer pool can cache at the same time
+static constexpr int SCAN_RING_SIZE = 32;                // frames recycled by a sequential scan
+static constexpr int VICTIM_SEARCH_DEPTH = 16;           // frames looked at when a clean victim is preferred
+static constexpr int FLUSHER_INTERVAL_MS = 10;           // pause of the background writer between two rounds
+static constexpr int FLUSHER_BATCH_SIZE = 16;            // pages written per shard and round by the background writer
+static constexpr int PREFETCH_DISTANCE = 4;              // pages a chain iterator reads ahead of itself
+static constexpr int PREFETCH_IO_THREADS = 2;            // threads serving read-ahead requests
+static constexpr int PREFETCH_QUEUE_SIZE = 64;           // pending read-ahead requests, more are dropped
+static constexpr int IO_URING_QUEUE_DEPTH = 64;          // page I/Os a disk manager keeps in flight through io_uring
+static constexpr int LRUK_DEFAULT_K = 2;                 // references remembered per page by the LRU-K replacer
+static constexpr int LRUK_CORRELATED_PERIOD = 16;        // references closer than this many ticks count as one
+static constexpr int CLOCK_SWEEP_MAX_USAGE = 5;          // usage count a frame can gather in the clock sweep
+static constexpr int PAGE_TRACE_BUFFER_RECORDS = 4096;   // page trace records collected before they are written
+static constexpr int COMPRESSED_PAGE_MAX_SIZE = PAGE_SIZE * 3 / 4;  // larger compressed pages are not cached
+static constexpr int EXTENT_RUN_SIZE = 16;               // contiguous pages reserved at a time for a table or index
+static constexpr int DATA_FILE_PAGE_BITS = 25;           // low bits of a page id, the page within its data file
+static constexpr int MAX_DATA_FILES = 1 << (31 - DATA_FILE_PAGE_BITS);  // data files of a database, high bits
+static constexpr int PAGE_SLOT_SIZE = 512;               // unit of the file space taken by a compressed page
+static constexpr int FSM_BUCKETS = 32;                   // classes of free space the pages of a table are sorted in
+static constexpr int BULK_INSERT_MIN_ROWS = 8;           // an insert of this many rows appends them as a batch
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
@@ -23,6 +49,8 @@ static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of var
 
 using page_id_t = int32_t;
 using frame_id_t = int32_t;
+using file_id_t = int32_t;
+using page_tag_t = int64_t;  // a page of the buffer pool: file id in the high half, page id in the low half
 using txn_id_t = int32_t;
 using lsn_t = int32_t;
 using column_id_t = uint32_t;
@@ -14,7 +14,19 @@
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  /**
+   * @param direct_io read and write the db file with O_DIRECT, so pages are cached by the buffer pool only
+   * @param compress_pages store the pages of a new database compressed, see DiskManager
+   */
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           ReplacerType replacer_type = ReplacerType::kLRU, bool direct_io = false,
+                           bool compress_pages = false);
+
+  /**
+   * Cache the pages of the database in a buffer pool shared with other databases.
+   */
+  DBStorageEngine(std::string db_name, bool init, std::shared_ptr<BufferPool> buffer_pool, bool direct_io = false,
+                  bool compress_pages = false);
 
   ~DBStorageEngine();
 
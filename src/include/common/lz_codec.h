@@ -0,0 +1,43 @@
+#ifndef MINISQL_LZ_CODEC_H
+#define MINISQL_LZ_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * LZCodec is a small LZ77 codec in the spirit of LZ4, tuned for speed rather than ratio.
+ *
+ * The output is a series of sequences. A sequence starts with a token byte, whose high nibble is the number of
+ * literals and low nibble the match length minus LZ_MIN_MATCH, 15 meaning more length bytes follow (255 each until a
+ * smaller one). Then come the literals, then the offset of the match as 2 bytes little endian and the extra match
+ * length bytes. The last sequence only has literals. Matches are found through a hash table of 4-byte prefixes and
+ * may overlap their own output, so runs of padding shrink to a few bytes.
+ */
+class LZCodec {
+ public:
+  /** @return the largest output Compress can produce for an input of size bytes */
+  static size_t MaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+
+  /**
+   * Compress a buffer.
+   * @param capacity room in dst, the output is abandoned as soon as it would not fit
+   * @return the size of the output, 0 if it did not fit in capacity
+   */
+  static size_t Compress(const char *src, size_t size, char *dst, size_t capacity);
+
+  /**
+   * Decompress a buffer produced by Compress.
+   * @param dst_size the size of the original data, dst must have room for it
+   * @return false if src is malformed or does not decompress to exactly dst_size bytes
+   */
+  static bool Decompress(const char *src, size_t size, char *dst, size_t dst_size);
+
+ private:
+  static constexpr size_t LZ_MIN_MATCH = 4;
+  static constexpr size_t LZ_MAX_OFFSET = 65535;
+  static constexpr int LZ_HASH_BITS = 12;
+  // the last bytes are always literals, so a match never reads past the input
+  static constexpr size_t LZ_LAST_LITERALS = 5;
+};
+
+#endif  // MINISQL_LZ_CODEC_H
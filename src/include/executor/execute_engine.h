@@ -73,9 +73,28 @@ class ExecuteEngine {
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteSet(pSyntaxNode ast, ExecuteContext *context);
+
+  /**
+   * SET data_files = n grows the tablespace of the current database to n data files, SET data_file = n places the
+   * tables and indexes created from then on in data file n.
+   */
+  dberr_t ExecuteSetDataFiles(const std::string &variable, const std::string &value);
+
+  dberr_t ExecuteShowStatus(pSyntaxNode ast, ExecuteContext *context);
+
+  /**
+   * VACUUM rebuilds the tables of the current database packed at the front of their data files, then cuts the free
+   * pages at the end of the files off.
+   */
+  dberr_t ExecuteVacuum(pSyntaxNode ast, ExecuteContext *context);
+
  private:
-  std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
+  std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all databases, null until first used */
   std::string current_db_;                                 /** current database */
+  std::shared_ptr<BufferPool> buffer_pool_;                /** frames shared by the pages of all databases */
+  uint32_t data_file_{0};                                  /** data file new tables and indexes are placed in */
+  bool compress_pages_{false};                             /** new databases store their pages compressed */
 };
 
 #endif  // MINISQL_EXECUTE_ENGINE_H
@@ -46,5 +46,9 @@ class IndexScanExecutor : public AbstractExecutor {
   TableInfo *table_info_{};
   vector<RowId> result_;
   size_t cursor_ = 0;
+  /** Reads the rows found in the index in place */
+  TableIterator iterator_;
+  /** Column of the table each output column is read from */
+  std::vector<uint32_t> column_indexes_;
   bool is_schema_same_;
 };
\ No newline at end of file
@@ -42,12 +42,34 @@ class InsertExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
  private:
+  /**
+   * Insert the rows pulled from the child one by one, each one with its index entries.
+   * @throws std::runtime_error if a row or one of its keys cannot be inserted, after the rows already in were undone
+   */
+  void InsertRows();
+
+  /**
+   * Insert all the rows pulled from the child at once: they are appended to the table, then each index takes their
+   * keys in order.
+   * @throws std::runtime_error if a row or one of the keys cannot be inserted, after the whole insert was undone
+   */
+  void InsertBatch();
+
+  /**
+   * Take out the index entries and the first rows of rows_ an insert put in, then forget the rows.
+   * @param inserted number of rows of rows_ in the table
+   */
+  void Undo(const std::vector<std::pair<Index *, Row>> &added, size_t inserted);
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
   TableInfo *table_info_{};
   const Schema *schema_{};
   std::vector<IndexInfo *> index_info_;
+  std::vector<Row> rows_;  // rows pulled from the child
+  size_t cursor_{0};       // next row of rows_ to report
+  bool drained_{false};    // the child has been pulled empty and its rows inserted
 };
 
 #endif  // MINISQL_INSERT_EXECUTOR_H
@@ -5,6 +5,7 @@
 #ifndef MINISQL_SEQ_SCAN_EXECUTOR_H
 #define MINISQL_SEQ_SCAN_EXECUTOR_H
 
+#include <memory>
 #include <vector>
 
 #include "executor/execute_context.h"
@@ -45,8 +46,13 @@ class SeqScanExecutor : public AbstractExecutor {
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
   TableInfo *table_info_{};
+  /** Ring of frames the scan reads through, so a big table does not flush the buffer pool */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
+  /** Goes before the ring, it unpins the page it is on */
   TableIterator iterator_;
   const Schema *schema_{};
+  /** Column of the table each output column is read from */
+  std::vector<uint32_t> column_indexes_;
   bool is_schema_same_;
 };
 
@@ -26,8 +26,14 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage;
 
  public:
+  /**
+   * @param data_file data file of the tablespace the nodes of the tree are allocated in
+   */
   explicit BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &comparator,
-                     int leaf_max_size = UNDEFINED_SIZE, int internal_max_size = UNDEFINED_SIZE);
+                     int leaf_max_size = UNDEFINED_SIZE, int internal_max_size = UNDEFINED_SIZE,
+                     uint32_t data_file = 0);
+
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -53,15 +59,21 @@ class BPlusTree {
   // used to check whether all pages are unpinned
   bool Check();
 
+  // leaves an iterator reads ahead of itself, 0 turns read-ahead off
+  void SetPrefetchDistance(int distance) { prefetch_distance_ = distance; }
+
   // destroy the b plus tree
   void Destroy(page_id_t current_page_id = INVALID_PAGE_ID);
 
+  // give back the pages reserved for the growth of the tree but not used yet
+  void ReleaseUnusedPages();
+
   void PrintTree(std::ofstream &out, Schema *schema) {
     if (IsEmpty()) {
       return;
     }
     std::cout << "digraph G {" << std::endl;
-    Page *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
+    Page *root_page = FetchNode(root_page_id_);
     auto *node = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
     ToGraph(node, buffer_pool_manager_, out, schema);
     std::cout << "}" << std::endl;
@@ -95,6 +107,11 @@ class BPlusTree {
 
   void UpdateRootPageId(int insert_record = 0);
 
+  /**
+   * Pin a node of the tree and tag it for the buffer pool statistics.
+   */
+  Page *FetchNode(page_id_t page_id) { return BPlusTreePage::TagPage(buffer_pool_manager_->FetchPage(page_id)); }
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out, Schema *schema) const;
 
@@ -107,6 +124,10 @@ class BPlusTree {
   KeyManager processor_;
   int leaf_max_size_;
   int internal_max_size_;
+  int prefetch_distance_{PREFETCH_DISTANCE};
+  // leaves and internal nodes grow from runs of their own, so that a range scan reads the leaves sequentially
+  ExtentAllocator leaf_extents_;
+  ExtentAllocator internal_extents_;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
@@ -7,7 +7,11 @@
 
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager);
+  /**
+   * @param data_file data file of the tablespace the nodes of the tree are allocated in
+   */
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager,
+                 uint32_t data_file = 0);
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Txn *txn) override;
 
@@ -17,6 +21,8 @@ class BPlusTreeIndex : public Index {
 
   dberr_t Destroy() override;
 
+  void ReleaseUnusedPages() override { container_.ReleaseUnusedPages(); }
+
   IndexIterator GetBeginIterator();
 
   IndexIterator GetBeginIterator(GenericKey *key);
@@ -5,6 +5,7 @@
 
 #include "record/field.h"
 #include "record/row.h"
+#include "record/row_view.h"
 
 class GenericKey {
   friend class KeyManager;
@@ -35,20 +36,19 @@ class KeyManager {
   [[nodiscard]] inline int CompareKeys(const GenericKey *lhs, const GenericKey *rhs) const {
     //    ASSERT(malloc_usable_size((void *)&lhs) == malloc_usable_size((void *)&rhs), "key size not match.");
     uint32_t column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    DeserializeToKey(lhs, lhs_key, key_schema_);
-    DeserializeToKey(rhs, rhs_key, key_schema_);
+    // the keys are read where they are, a comparison decodes the columns up to the first that differs
+    RowView lhs_key(lhs->data, key_schema_);
+    RowView rhs_key(rhs->data, key_schema_);
 
     for (uint32_t i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
+      Field lhs_value = lhs_key.GetField(i);
+      Field rhs_value = rhs_key.GetField(i);
 
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue) {
+      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::kTrue) {
         return -1;
       }
 
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue) {
+      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::kTrue) {
         return 1;
       }
     }
@@ -21,6 +21,11 @@ class Index {
 
   virtual dberr_t Destroy() = 0;
 
+  /**
+   * Give back the pages the index reserved to grow into but did not use, e.g. once it is rebuilt.
+   */
+  virtual void ReleaseUnusedPages() {}
+
  protected:
   index_id_t index_id_;
   IndexSchema *key_schema_;
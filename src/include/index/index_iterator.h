@@ -1,6 +1,7 @@
 #ifndef MINISQL_INDEX_ITERATOR_H
 #define MINISQL_INDEX_ITERATOR_H
 
+#include "buffer/read_ahead_window.h"
 #include "page/b_plus_tree_leaf_page.h"
 
 class IndexIterator {
@@ -10,7 +11,11 @@ class IndexIterator {
   // you may define your own constructor based on your member variables
   explicit IndexIterator();
 
-  explicit IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index = 0);
+  /**
+   * @param prefetch_distance leaves read ahead of the iterator, 0 turns read-ahead off
+   */
+  explicit IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index = 0,
+                         int prefetch_distance = PREFETCH_DISTANCE);
 
   ~IndexIterator();
 
@@ -31,6 +36,7 @@ class IndexIterator {
   LeafPage *page{nullptr};
   int item_index{0};
   BufferPoolManager *buffer_pool_manager{nullptr};
+  ReadAheadWindow read_ahead{nullptr, nullptr, 0};  // leaves requested ahead of the current one
   // add your own private member variables here
 };
 
@@ -59,6 +59,12 @@ class BPlusTreePage {
 
   void SetLSN(lsn_t lsn = INVALID_LSN);
 
+  /**
+   * Tag a pinned page holding a node as a leaf or internal page for the buffer pool statistics.
+   * @return the page, nullptr if it is nullptr
+   */
+  static Page *TagPage(Page *page);
+
  private:
   // member variable, attributes that both internal and leaf page share
   [[maybe_unused]] IndexPageType page_type_;
@@ -20,6 +20,19 @@ class BitmapPage {
    */
   bool AllocatePage(uint32_t &page_offset);
 
+  /**
+   * Allocate the first run of contiguous free pages long enough.
+   * @param page_offset Index in extent of the first page of the run.
+   * @return true if the extent had such a run.
+   */
+  bool AllocateRun(uint32_t num_pages, uint32_t &page_offset);
+
+  /**
+   * Allocate a given page, to rebuild a bitmap from the pages known to be in use.
+   * @return false if the page is in use already.
+   */
+  bool AllocatePageAt(uint32_t page_offset);
+
   /**
    * @return true if successfully de-allocate a page.
    */
@@ -30,6 +43,11 @@ class BitmapPage {
    */
   bool IsPageFree(uint32_t page_offset) const;
 
+  /**
+   * @return one past the offset of the last allocated page, 0 if the extent is empty
+   */
+  uint32_t GetUsedEnd() const;
+
  private:
   /**
    * check a bit(byte_index, bit_index) in bytes is free(value 0).
@@ -40,6 +58,12 @@ class BitmapPage {
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /**
+   * Find the first free (or used) page at or after an offset, a 64-bit word of the bitmap at a time.
+   * @return false if there is none from there on
+   */
+  bool FindPage(uint32_t from, bool is_free, uint32_t &page_offset) const;
+
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
 
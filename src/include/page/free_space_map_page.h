@@ -0,0 +1,62 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * A page of the free-space map of a table. It records, for the table pages in the order they were added, the class
+ * of free space of each one, see FreeSpaceMap. The pages of a map are chained.
+ *
+ * Format (size in byte):
+ *  -------------------------------------------------------------------------------------------------
+ * | NextPageId (4) | EntryCount (4) | Page_1 id (4) | ... | Page_N id (4) | Bucket_1 (1) | ... | ... |
+ *  -------------------------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  static constexpr uint32_t MAX_ENTRY_COUNT = (PAGE_SIZE - 8) / (sizeof(page_id_t) + sizeof(uint8_t));
+
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  uint32_t GetEntryCount() const { return count_; }
+
+  page_id_t GetPageId(uint32_t index) const { return page_ids_[index]; }
+
+  uint8_t GetBucket(uint32_t index) const { return Buckets()[index]; }
+
+  void SetBucket(uint32_t index, uint8_t bucket) { Buckets()[index] = bucket; }
+
+  /**
+   * @return false if the page is full
+   */
+  bool Append(page_id_t page_id, uint8_t bucket) {
+    if (count_ == MAX_ENTRY_COUNT) {
+      return false;
+    }
+    page_ids_[count_] = page_id;
+    SetBucket(count_++, bucket);
+    return true;
+  }
+
+ private:
+  // the classes follow the largest array of page ids the page can hold
+  uint8_t *Buckets() { return reinterpret_cast<uint8_t *>(page_ids_ + MAX_ENTRY_COUNT); }
+
+  const uint8_t *Buckets() const { return reinterpret_cast<const uint8_t *>(page_ids_ + MAX_ENTRY_COUNT); }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t count_;
+  page_id_t page_ids_[0];
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_PAGE_H
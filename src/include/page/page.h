@@ -3,25 +3,66 @@
 
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <shared_mutex>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
 
+/**
+ * What a page holds, as far as the buffer pool statistics are concerned. The owner of a page tags it after pinning it,
+ * the pool only reports its counters per type.
+ */
+enum class PageType : uint8_t {
+  kUnknown = 0,    // not tagged (yet)
+  kTable,          // page of a table heap
+  kIndexInternal,  // B+ tree internal node
+  kIndexLeaf,      // B+ tree leaf node
+  kBitmap,         // allocation bitmap of an extent
+  kCatalog,        // catalog meta, index roots and table or index metadata
+  kNumPageTypes
+};
+
+static constexpr size_t NUM_PAGE_TYPES = static_cast<size_t>(PageType::kNumPageTypes);
+
+inline const char *PageTypeToString(PageType page_type) {
+  switch (page_type) {
+    case PageType::kTable:
+      return "table";
+    case PageType::kIndexInternal:
+      return "index internal";
+    case PageType::kIndexLeaf:
+      return "index leaf";
+    case PageType::kBitmap:
+      return "bitmap";
+    case PageType::kCatalog:
+      return "catalog";
+    default:
+      return "unknown";
+  }
+}
+
 /**
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The data itself lives outside of the Page, in a frame of the arena of the buffer pool, so that frames are aligned
+ * for direct I/O and the book-keeping of neighbouring frames does not sit between their data. The book-keeping is
+ * padded to whole cache lines, threads pinning neighbouring frames do not invalidate each other's latches.
  */
-class Page {
+class alignas(CACHE_LINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
-  friend class BufferPoolManager;
+  friend class BufferPool;
 
  public:
   DISALLOW_COPY(Page)
 
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor of a page outside of the buffer pool. Allocates and zeros out the page data. */
+  Page() : owned_data_(new char[PAGE_SIZE]), data_(owned_data_.get()) { ResetMemory(); }
+
+  /** Constructor of a page over PAGE_SIZE bytes held by the caller, e.g. a frame of the buffer pool. */
+  explicit Page(char *data) : data_(data) {}
 
   /** Default destructor. */
   ~Page() = default;
@@ -38,6 +79,12 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
 
+  /** @return what the page holds, as tagged by its owner */
+  inline PageType GetPageType() { return page_type_; }
+
+  /** Tag the page for the buffer pool statistics, the page must be pinned. */
+  inline void SetPageType(PageType page_type) { page_type_ = page_type; }
+
   /** Acquire the page write latch. */
   inline void WLatch() { rwlatch_.WLock(); }
 
@@ -68,14 +115,24 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  /** The data of a page that is not held by anyone else. */
+  std::unique_ptr<char[]> owned_data_;
+  /** The actual data that is stored within a page, PAGE_SIZE bytes. */
+  char *data_{nullptr};
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
+  /** The file of the buffer pool this page belongs to. */
+  file_id_t file_id_ = 0;
   /** The pin count of this page. */
   int pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** What the page holds, kept while the page is resident. */
+  PageType page_type_ = PageType::kUnknown;
+  /** True if the page was read by a fetch that is counted once the page is tagged, i.e. when it is unpinned. */
+  bool miss_pending_ = false;
+  /** Number of waits for a write of the page counted along with the pending miss. */
+  int waits_pending_ = 0;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
@@ -1,5 +1,6 @@
 %{
   #include <stdio.h>
+  #include <string.h>
   #include "parser/parser.h"
 
   extern char *yytext;
@@ -26,8 +27,8 @@
 %type <syntax_node> sql_trx_begin sql_trx_commit sql_trx_rollback
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
-%type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_insert value_lists sql_delete sql_update update_values update_value
+%type <syntax_node> sql_quit sql_exec_file sql_set sql_show_status sql_vacuum
 
 %%
 
@@ -58,6 +59,9 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_set { $$ = $1; }
+  | sql_show_status { $$ = $1; }
+  | sql_vacuum { $$ = $1; }
   ;
 
 sql_create_database:
@@ -289,12 +293,22 @@ operator:
   ;
 
 sql_insert:
-  INSERT INTO IDENTIFIER VALUES '(' column_values ')' {
+  INSERT INTO IDENTIFIER VALUES value_lists {
     $$ = CreateSyntaxNode(kNodeInsert, NULL);
     SyntaxNodeAddChildren($$, $3);
-    pSyntaxNode col_val_node = CreateSyntaxNode(kNodeColumnValues, NULL);
-    SyntaxNodeAddChildren(col_val_node, $6);
-    SyntaxNodeAddChildren($$, col_val_node);
+    SyntaxNodeAddChildren($$, $5);
+  }
+  ;
+
+value_lists:
+  '(' column_values ')' ',' value_lists {
+    $$ = CreateSyntaxNode(kNodeColumnValues, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddSibling($$, $5);
+  }
+  | '(' column_values ')' {
+    $$ = CreateSyntaxNode(kNodeColumnValues, NULL);
+    SyntaxNodeAddChildren($$, $2);
   }
   ;
 
@@ -393,6 +407,39 @@ sql_exec_file:
   }
   ;
 
+sql_set:
+  SET IDENTIFIER EQ NUMBER {
+    if (!MinisqlParserIsVariable($2->val_)) {
+      yyerror("unknown variable in set statement");
+      YYERROR;
+    }
+    $$ = CreateSyntaxNode(kNodeSet, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
+/* bufferpool, status and vacuum are matched by text rather than being keywords, they stay usable as names */
+sql_show_status:
+  SHOW IDENTIFIER IDENTIFIER {
+    if (strcmp($2->val_, "bufferpool") != 0 || strcmp($3->val_, "status") != 0) {
+      yyerror("unknown show statement");
+      YYERROR;
+    }
+    $$ = CreateSyntaxNode(kNodeShowStatus, NULL);
+  }
+  ;
+
+sql_vacuum:
+  IDENTIFIER {
+    if (strcmp($1->val_, "vacuum") != 0) {
+      yyerror("syntax error");
+      YYERROR;
+    }
+    $$ = CreateSyntaxNode(kNodeVacuum, NULL);
+  }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
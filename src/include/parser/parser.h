@@ -22,4 +22,9 @@ int MinisqlParserGetError();
 
 char *MinisqlParserGetErrorMessage();
 
+/**
+ * Whether a name is a server variable that SET can assign, an unknown one is a parse error.
+ */
+int MinisqlParserIsVariable(const char *name);
+
 #endif  // MINISQL_PARSER_H
@@ -43,7 +43,10 @@ typedef enum {
   kNodeIndexType,            /** type of index */
   kNodeTrxBegin,             /** begin recovery command */
   kNodeTrxCommit,            /** commit recovery command */
-  kNodeTrxRollback           /** rollback recovery command */
+  kNodeTrxRollback,          /** rollback recovery command */
+  kNodeSet,                  /** set command, assigns a number to a server variable */
+  kNodeShowStatus,           /** show status command, e.g. show bufferpool status */
+  kNodeVacuum                /** vacuum command */
 } SyntaxNodeType;
 
 /**
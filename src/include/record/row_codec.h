@@ -0,0 +1,70 @@
+#ifndef MINISQL_ROW_CODEC_H
+#define MINISQL_ROW_CODEC_H
+
+#include <vector>
+
+#include "record/column.h"
+#include "record/field.h"
+
+/**
+ * RowCodec serializes the fields of a row for one schema, the schema builds it once with its columns.
+ *
+ * The type of each column is looked at when the codec is built, the fields are then read and written by code
+ * specialized per type instead of through the Type singletons. A schema of int and float columns is fixed-width: a row
+ * of it without nulls has a known size and each of its fields a known offset, so that it is copied field by field
+ * without looking at anything else. Rows of other schemas are walked column by column. The null bitmap is written in
+ * place in the buffer and read there, nothing is allocated but the fields a row is read into.
+ */
+class RowCodec {
+ public:
+  /** Offset of a column whose position depends on the length of the char columns before it. */
+  static constexpr uint32_t VARIABLE_OFFSET = UINT32_MAX;
+
+  explicit RowCodec(const std::vector<Column *> &columns);
+
+  /**
+   * @return bytes written, as many as GetSerializedSize
+   */
+  uint32_t SerializeTo(const std::vector<Field *> &fields, char *buf) const;
+
+  /**
+   * Read a row into new fields appended to fields.
+   * @return bytes read
+   */
+  uint32_t DeserializeFrom(const char *buf, std::vector<Field *> &fields) const;
+
+  uint32_t GetSerializedSize(const std::vector<Field *> &fields) const;
+
+  /** @return bytes of the field count and null bitmap a serialized row starts with */
+  inline uint32_t GetHeaderSize() const { return header_size_; }
+
+  /** @return offset of a column in a row whose columns before it are not null, VARIABLE_OFFSET after a char column */
+  inline uint32_t GetFixedOffset(uint32_t column_index) const { return fixed_offsets_[column_index]; }
+
+  /** @return true if rows without nulls all have the same size */
+  inline bool IsFixedWidth() const { return fixed_width_; }
+
+ private:
+  template <TypeId type>
+  static uint32_t WriteField(const Field &field, char *buf);
+
+  template <TypeId type>
+  static uint32_t ReadField(const char *buf, Field **field);
+
+  template <TypeId type>
+  static uint32_t GetFieldSize(const Field &field);
+
+  static uint32_t WriteField(TypeId type, const Field &field, char *buf);
+
+  static uint32_t ReadField(TypeId type, const char *buf, Field **field);
+
+  static uint32_t GetFieldSize(TypeId type, const Field &field);
+
+  std::vector<TypeId> types_;
+  std::vector<uint32_t> fixed_offsets_;
+  uint32_t header_size_;
+  uint32_t fixed_size_;  // size of a row without nulls of a fixed-width schema
+  bool fixed_width_;
+};
+
+#endif  // MINISQL_ROW_CODEC_H
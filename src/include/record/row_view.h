@@ -0,0 +1,72 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <vector>
+
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * RowView reads the fields of a serialized row in place, e.g. in a pinned table page or in an index key.
+ *
+ * Only the columns asked for are decoded. The offset of a column comes from the offset table of the schema when no
+ * column before it is null, otherwise the null bitmap and the lengths of the char columns before it are walked. Char
+ * fields handed out by GetField borrow the bytes of the row, they are valid as long as the bytes are.
+ */
+class RowView {
+ public:
+  RowView() = default;
+
+  RowView(const char *data, const Schema *schema, RowId rid = RowId())
+      : data_(data), schema_(schema), rid_(rid), walked_offset_(schema->GetRowHeaderSize()) {}
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const { return schema_->GetColumnCount(); }
+
+  inline bool IsNull(uint32_t column_index) const {
+    return (data_[sizeof(uint32_t) + column_index / 8] & (1 << (column_index % 8))) != 0;
+  }
+
+  /**
+   * @return the field of a column, a char field points into the row
+   */
+  Field GetField(uint32_t column_index) const;
+
+  /**
+   * Decode every column into a row that owns its fields.
+   */
+  void GetRow(Row *row) const;
+
+  /**
+   * Decode some columns, in the order given, into a row that owns its fields.
+   */
+  void GetRow(const std::vector<uint32_t> &column_indexes, Row *row) const;
+
+  /**
+   * @return bytes of the serialized row
+   */
+  uint32_t GetSerializedSize() const;
+
+ private:
+  /** @return offset of a column from the start of the row */
+  uint32_t GetOffset(uint32_t column_index) const;
+
+  /** @return bytes taken by a column whose value starts at offset */
+  uint32_t GetStoredSize(uint32_t column_index, uint32_t offset) const;
+
+  bool HasNullBefore(uint32_t column_index) const;
+
+  /** @return a copy of the field of a column, char data included */
+  Field *NewField(uint32_t column_index) const;
+
+  const char *data_{nullptr};
+  const Schema *schema_{nullptr};
+  RowId rid_{};
+  mutable uint32_t walked_column_{0};  // last column the walk reached, later columns are walked to from there
+  mutable uint32_t walked_offset_{0};
+};
+
+#endif  // MINISQL_ROW_VIEW_H
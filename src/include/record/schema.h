@@ -6,14 +6,18 @@
 #include "common/macros.h"
 #include "glog/logging.h"
 #include "record/column.h"
+#include "record/row_codec.h"
 
 #ifndef MINISQL_SCHEMA_H
 #define MINISQL_SCHEMA_H
 
 class Schema {
  public:
+  /** Offset of a column whose position depends on the length of the char columns before it. */
+  static constexpr uint32_t VARIABLE_OFFSET = RowCodec::VARIABLE_OFFSET;
+
   explicit Schema(const std::vector<Column *> columns, bool is_manage_ = true)
-      : columns_(std::move(columns)), is_manage_(is_manage_) {}
+      : columns_(std::move(columns)), is_manage_(is_manage_), codec_(columns_) {}
 
   ~Schema() {
     if (is_manage_) {
@@ -39,6 +43,18 @@ class Schema {
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /** @return bytes of the field count and null bitmap a serialized row starts with */
+  inline uint32_t GetRowHeaderSize() const { return codec_.GetHeaderSize(); }
+
+  /**
+   * @return offset of a column in a serialized row whose columns before it are not null, VARIABLE_OFFSET if a char
+   * column comes before it
+   */
+  inline uint32_t GetFixedOffset(const uint32_t column_index) const { return codec_.GetFixedOffset(column_index); }
+
+  /** @return the codec rows of this schema are serialized with */
+  inline const RowCodec &GetCodec() const { return codec_; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -84,6 +100,7 @@ class Schema {
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;
   bool is_manage_ = false; /** if false, don't need to delete pointer to column */
+  RowCodec codec_; /** built from the columns, they do not change */
 };
 
 using IndexSchema = Schema;
@@ -1,16 +1,24 @@
 #ifndef DISK_MGR_H
 #define DISK_MGR_H
 
+#include <array>
 #include <atomic>
-#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/io_uring_engine.h"
+
+static_assert(MAX_VALID_PAGE_ID <= (1 << DATA_FILE_PAGE_BITS), "Pages of a data file must fit in the low bits.");
+static_assert(BitmapPage<PAGE_SIZE>::GetMaxSupportedSize() % (PAGE_SIZE / PAGE_SLOT_SIZE) == 0,
+              "The slots of a slot bitmap must lie in one extent.");
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
@@ -19,10 +27,52 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * Pages are read and written with pread/pwrite on a single descriptor, so page I/O of different threads runs in
+ * parallel and only allocation takes the latch. Writes are not flushed: they become durable on the next Sync().
+ *
+ * The meta page and the bitmap pages stay in memory once read, so allocating, freeing and checking a page cost no I/O.
+ * The bitmaps changed since are written back with the meta page by Checkpoint(), and by Close().
+ *
+ * ReadPageAsync and WritePageAsync submit through an io_uring when the kernel offers one, keeping up to
+ * IO_URING_QUEUE_DEPTH page I/Os in flight. Without it they run synchronously and call back before returning.
+ *
+ * In direct I/O mode the file is opened with O_DIRECT and bypasses the kernel page cache, so pages are cached once,
+ * in the buffer pool. Buffers aligned to PAGE_SIZE, like the frames of the buffer pool, are read and written in place,
+ * others go through a bounce buffer.
+ *
+ * A database is a tablespace of up to MAX_DATA_FILES data files. The file the disk manager is opened with is data file
+ * 0, AddDataFile appends the others and records them in a manifest next to it, ".<db file>.files", one path per line.
+ * The data file of a page is in the high bits of its id, above DATA_FILE_PAGE_BITS, so the pages of file 0 keep the
+ * ids they had before and the ids of the others are still plain page_id_t: rows, index entries and page headers
+ * address them as they are. Each data file is a DiskManager of its own, with its meta page and bitmaps, and the calls
+ * for its pages are passed on to it.
+ *
+ * A database created with page compression stores every page compressed by LZCodec, in a run of PAGE_SLOT_SIZE slots.
+ * The slots take the place of the pages in the extents, slot s in page s / SLOTS_PER_PAGE, and are allocated lowest
+ * first, so the file ends after the compressed size of the database. A page that does not save a slot is stored as it
+ * is. The page map, ".<db file>.map", holds the slots of every page: 8 bytes per page, slot << 16 | size, 0 if the
+ * page was never written. Its presence is what marks the file as compressed. Pages are written copy on write, to new
+ * slots, and the old ones are freed by the checkpoint that writes the map, so the map on disk only ever points to
+ * slots that hold what it says. The slot bitmaps are BitmapPages of their own, built from the map when it is read.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  /** Called once an asynchronous page I/O is done. */
+  using IOCallback = std::function<void()>;
+
+  /**
+   * @param use_io_uring false keeps the asynchronous calls on the synchronous path
+   * @param direct_io open the file with O_DIRECT, falls back to buffered I/O if the file system refuses it
+   * @param compress_pages store the pages compressed if the file is new, an existing file keeps its format
+   */
+  explicit DiskManager(const std::string &db_file, bool use_io_uring = true, bool direct_io = false,
+                       bool compress_pages = false);
+
+  /**
+   * Delete a database file, its other data files, their page maps and the manifest.
+   */
+  static void RemoveFiles(const std::string &db_file);
 
   ~DiskManager() {
     if (!closed) {
@@ -42,11 +92,58 @@ class DiskManager {
    */
   void WritePage(page_id_t logical_page_id, const char *page_data);
 
+  /**
+   * Read a page in the background. The buffer must stay valid until done is called, on the completion thread.
+   */
+  void ReadPageAsync(page_id_t logical_page_id, char *page_data, IOCallback done);
+
+  /**
+   * Write a page in the background. The buffer must stay valid until done is called, on the completion thread.
+   */
+  void WritePageAsync(page_id_t logical_page_id, const char *page_data, IOCallback done);
+
+  /**
+   * @return true if asynchronous page I/O goes through io_uring
+   */
+  bool IsAsync();
+
+  /**
+   * @return true if the file is accessed with O_DIRECT
+   */
+  bool IsDirectIO() const { return direct_io_; }
+
+  /**
+   * @return true if the pages are stored compressed
+   */
+  bool IsCompressed() const { return map_fd_ >= 0; }
+
+  /**
+   * Make every write issued so far durable. Concurrent callers share one fdatasync: a caller whose writes were
+   * covered by a sync that started after them returns without syncing again.
+   */
+  void Sync();
+
+  /**
+   * Write the bitmaps changed since the last checkpoint and the meta page, then Sync(). Until then a crash loses the
+   * allocations and deallocations done in between.
+   */
+  void Checkpoint();
+
   /**
    * Get next free page from disk
+   * @param data_file data file of the tablespace the page is taken from
    * @return logical page id of allocated page
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(uint32_t data_file = 0);
+
+  /**
+   * Allocate a run of pages with consecutive ids, which are also consecutive in the file. The run is taken from the
+   * first extent with room for it, first fit within the extent.
+   * @param num_pages length of the run, at most BITMAP_SIZE
+   * @param data_file data file of the tablespace the run is taken from
+   * @return logical page id of the first page of the run, INVALID_PAGE_ID if it cannot be allocated
+   */
+  page_id_t AllocateExtent(uint32_t num_pages, uint32_t data_file = 0);
 
   /**
    * Free this page and reset bit map
@@ -59,10 +156,51 @@ class DiskManager {
   bool IsPageFree(page_id_t logical_page_id);
 
   /**
-   * Shut down the disk manager and close all the file resources.
+   * Cut the free pages at the end of every data file off the file, then checkpoint. Pages past the last allocated one
+   * must not be written any more, the buffer pool drops the frames of the pages it deletes. The pages of a compressed
+   * file are packed into the lowest free slots first, their ids do not change.
+   * @return number of pages the files lost
+   */
+  uint64_t Truncate();
+
+  /**
+   * @return number of pages the data files of the tablespace take on disk
+   */
+  uint64_t GetFilePages() const;
+
+  /**
+   * Shut down the disk manager and close all the file resources, after a checkpoint.
    */
   void Close();
 
+  /**
+   * Add a data file to the tablespace, an existing file is used as it is. Once recorded in the manifest, it is opened
+   * again with the database.
+   * @return number of the new data file, 0 if the tablespace has MAX_DATA_FILES already
+   */
+  uint32_t AddDataFile(const std::string &file_name);
+
+  /** @return number of data files of the tablespace, this one included */
+  uint32_t GetDataFileCount() const { return num_data_files_.load(); }
+
+  /** @return path of a data file */
+  const std::string &GetDataFileName(uint32_t data_file) const {
+    return data_file == 0 ? file_name_ : data_files_[data_file]->file_name_;
+  }
+
+  /** @return id of a page of a data file from its id within the file */
+  static page_id_t MakePageId(uint32_t data_file, page_id_t local_page_id) {
+    return static_cast<page_id_t>(data_file << DATA_FILE_PAGE_BITS | static_cast<uint32_t>(local_page_id));
+  }
+
+  /** @return data file holding a page, 0 for INVALID_PAGE_ID */
+  static uint32_t DataFileOf(page_id_t page_id) {
+    return page_id < 0 ? 0 : static_cast<uint32_t>(page_id) >> DATA_FILE_PAGE_BITS;
+  }
+
+  /** @return id of a page within its data file */
+  static page_id_t LocalPageId(page_id_t page_id) { return page_id & ((1 << DATA_FILE_PAGE_BITS) - 1); }
+
   /**
    * Get Meta Page
    * Note: Used only for debug
@@ -70,12 +208,13 @@ class DiskManager {
   char *GetMetaData() { return meta_data_; }
 
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+  static constexpr size_t SLOTS_PER_PAGE = PAGE_SIZE / PAGE_SLOT_SIZE;
 
  private:
   /**
    * Helper function to get disk file size
    */
-  int GetFileSize(const std::string &file_name);
+  static int64_t GetFileSize(int fd);
 
   /**
    * Read physical page from disk
@@ -87,18 +226,134 @@ class DiskManager {
    */
   void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
 
+  /**
+   * @return true if a buffer can take part in I/O on the file as it is
+   */
+  bool IsAligned(const char *page_data) const;
+
+  /**
+   * Account for a page, or a run of slots, that reached the file
+   */
+  void OnPageWritten(int64_t offset, int64_t size = PAGE_SIZE);
+
+  /**
+   * pread until size bytes are read, the end of the file is reached or an error occurs
+   * @return number of bytes read
+   */
+  static size_t ReadFully(int fd, char *data, size_t size, int64_t offset);
+
+  /**
+   * pwrite until size bytes are written
+   * @return false on an I/O error
+   */
+  static bool WriteFully(int fd, const char *data, size_t size, int64_t offset);
+
+  /**
+   * @return the io_uring engine, created on first use, null if there is none
+   */
+  IoUringEngine *AsyncEngine();
+
   /**
    * Map logical page id to physical page id
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
+  static page_id_t BitmapPageId(uint32_t extent_id) { return 1 + extent_id * (BITMAP_SIZE + 1); }
+
+  /**
+   * @return the resident bitmap of an extent, read on first use; an extent past the last one gets an empty bitmap.
+   * Caller holds db_io_latch_.
+   */
+  BitmapPage<PAGE_SIZE> *GetBitmap(uint32_t extent_id);
+
+  /**
+   * @return the disk manager of the data file holding a page, null if it is this one
+   */
+  DiskManager *DataFile(page_id_t page_id);
+
+  static std::string ManifestName(const std::string &db_file);
+
+  static std::string MapName(const std::string &db_file);
+
+  /**
+   * Open the page map of the file, create it if create is set, and mark the slots it points to in the slot bitmaps.
+   */
+  void OpenPageMap(bool create);
+
+  /**
+   * Read a page from its slots, a page never written reads as zeros.
+   */
+  void ReadCompressedPage(page_id_t logical_page_id, char *page_data);
+
+  /**
+   * Compress a page into new slots and point the map to them.
+   */
+  void WriteCompressedPage(page_id_t logical_page_id, const char *page_data);
+
+  /**
+   * @return first slot of a free run of num_slots slots, lowest first. Caller holds map_latch_.
+   */
+  uint64_t AllocateSlots(uint32_t num_slots);
+
+  /**
+   * Free the slots of a map entry. Caller holds map_latch_.
+   */
+  void FreeSlots(uint64_t entry);
+
+  /** @return position of a slot in the file */
+  int64_t SlotOffset(uint64_t slot) {
+    return static_cast<int64_t>(MapPageId(slot / SLOTS_PER_PAGE)) * PAGE_SIZE + slot % SLOTS_PER_PAGE * PAGE_SLOT_SIZE;
+  }
+
+  /**
+   * Move the pages to the lowest free runs of slots below them, the last ones first. The slots they leave are freed by
+   * the next checkpoint.
+   */
+  void CompactSlots();
+
+  /**
+   * Write the changed blocks of the page map once the slots they point to are durable, then free the slots of the
+   * copies replaced since the last checkpoint.
+   */
+  void CheckpointPageMap();
+
+  /**
+   * Open a data file in the next slot of the tablespace. Caller holds db_io_latch_.
+   */
+  void OpenDataFile(const std::string &file_name);
+
  private:
-  // stream to write db file
-  std::fstream db_io_;
+  // descriptor of the db file
+  int db_fd_{-1};
   std::string file_name_;
-  // with multiple buffer pool instances, need to protect file access
+  // size of the db file, kept up to date by the writes instead of asking the file system on every read
+  std::atomic<int64_t> file_size_{0};
+  // buffer pool shards allocate concurrently, need to protect the meta page and the bitmaps
   std::recursive_mutex db_io_latch_;
+  // writes issued so far and the number of them a finished Sync() covered
+  std::atomic<uint64_t> write_count_{0};
+  uint64_t synced_count_{0};
+  std::mutex sync_latch_;  // held during fdatasync, protects synced_count_
+  bool use_io_uring_;
+  bool direct_io_;
+  std::once_flag io_uring_once_;
+  std::unique_ptr<IoUringEngine> io_uring_;
   bool closed{false};
+  // bitmap page of every extent read so far, and whether it changed since the last checkpoint
+  std::vector<std::unique_ptr<BitmapPage<PAGE_SIZE>>> bitmaps_;
+  std::vector<bool> bitmap_dirty_;
+  uint32_t next_free_extent_{0};  // every extent below this one is full
+  // the other data files of the tablespace by number, a slot is set before the count covers it and never changes again
+  std::array<std::unique_ptr<DiskManager>, MAX_DATA_FILES> data_files_;
+  std::atomic<uint32_t> num_data_files_{1};
+  // page map of a compressed file: slots of every page, changed blocks of the map and entries replaced since the last
+  // checkpoint, whose slots are freed once the map no longer points to them on disk
+  int map_fd_{-1};
+  std::mutex map_latch_;  // protects the page map and the slot bitmaps, taken after db_io_latch_
+  std::vector<uint64_t> page_map_;
+  std::vector<bool> map_dirty_;
+  std::vector<uint64_t> replaced_entries_;
+  std::vector<std::unique_ptr<BitmapPage<PAGE_SIZE>>> slot_bitmaps_;
   char meta_data_[PAGE_SIZE]; // 这个就是meta_data，只需要转换一下就行
 };
 
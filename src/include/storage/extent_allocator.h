@@ -0,0 +1,58 @@
+#ifndef MINISQL_EXTENT_ALLOCATOR_H
+#define MINISQL_EXTENT_ALLOCATOR_H
+
+#include <mutex>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk_manager.h"
+
+/**
+ * ExtentAllocator hands out the pages of one object, a table heap or the leaves of an index, from runs of contiguous
+ * pages reserved with DiskManager::AllocateExtent. The pages of the object then follow each other in the file instead
+ * of interleaving with those of other objects, and a scan along them reads sequential blocks.
+ *
+ * The pages of the current run not handed out yet stay allocated on disk until Release, which the owner calls when it
+ * goes away. When no run can be reserved any more, pages are allocated one at a time.
+ *
+ * All the pages come from one data file of the tablespace, which places the object on it.
+ */
+class ExtentAllocator {
+ public:
+  /**
+   * @param run_size pages reserved at a time
+   * @param data_file data file the pages are allocated in
+   */
+  explicit ExtentAllocator(uint32_t run_size = EXTENT_RUN_SIZE, uint32_t data_file = 0)
+      : run_size_(run_size), data_file_(data_file) {}
+
+  ~ExtentAllocator() { ASSERT(next_ == end_, "Pages reserved by an extent allocator were not released."); }
+
+  DISALLOW_COPY(ExtentAllocator)
+
+  /**
+   * @return the next page of the run, reserving a new run if it is used up; INVALID_PAGE_ID if the file is full
+   */
+  page_id_t AllocatePage(DiskManager *disk_manager);
+
+  /**
+   * Give back a page that was handed out but not used, it is handed out again if it was the last one.
+   */
+  void DeAllocatePage(DiskManager *disk_manager, page_id_t page_id);
+
+  /**
+   * Give back the pages of the run not handed out yet.
+   */
+  void Release(DiskManager *disk_manager);
+
+  uint32_t GetDataFile() const { return data_file_; }
+
+ private:
+  uint32_t run_size_;
+  uint32_t data_file_;
+  std::mutex latch_;                // protects the run
+  page_id_t next_{INVALID_PAGE_ID};  // next page of the run to hand out
+  page_id_t end_{INVALID_PAGE_ID};   // past the last page of the run
+};
+
+#endif  // MINISQL_EXTENT_ALLOCATOR_H
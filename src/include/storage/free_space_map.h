@@ -0,0 +1,80 @@
+#ifndef MINISQL_FREE_SPACE_MAP_H
+#define MINISQL_FREE_SPACE_MAP_H
+
+#include <array>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/free_space_map_page.h"
+
+/**
+ * FreeSpaceMap tells a table heap which of its pages has room for a row, so an insert goes to such a page at once
+ * instead of trying the pages along the chain.
+ *
+ * Each table page is in one of FSM_BUCKETS classes, class b meaning at least b * PAGE_SIZE / FSM_BUCKETS free bytes.
+ * The classes are stored in a chain of FreeSpaceMapPages, five bytes per table page (its page id and its class), and
+ * kept in memory as the set of pages of each class. The map is read once when the table is opened, and written
+ * through the buffer pool as the classes change. It is a hint: the page is checked all the same, and a page found
+ * short of room is filed again.
+ */
+class FreeSpaceMap {
+ public:
+  /**
+   * @param first_page_id first page of the map, INVALID_PAGE_ID to create an empty one
+   * @param data_file data file the pages of a new map are allocated in
+   */
+  FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, uint32_t data_file);
+
+  DISALLOW_COPY(FreeSpaceMap)
+
+  /**
+   * @return a page with at least size free bytes, the lowest one of the smallest class that fits; INVALID_PAGE_ID if
+   * the table has none
+   */
+  page_id_t FindPage(uint32_t size);
+
+  /**
+   * Record a page added at the end of the table.
+   */
+  void AddPage(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Record the free space of a page after an insert, update or delete.
+   */
+  void UpdatePage(page_id_t page_id, uint32_t free_space);
+
+  /** @return the page added last, which ends the chain of the table */
+  page_id_t GetLastPageId() const { return last_page_id_; }
+
+  /** @return the first page of the map, recorded in the metadata of the table */
+  page_id_t GetFirstPageId() const { return first_page_id_; }
+
+  /**
+   * Delete the pages of the map.
+   */
+  void Destroy();
+
+ private:
+  struct Entry {
+    page_id_t map_page_id_;  // page of the map and index in it
+    uint32_t index_;
+    uint8_t bucket_;
+  };
+
+  static uint8_t BucketOf(uint32_t free_space);
+
+  /** Pin a page of the map, tagged with the table pages it describes. */
+  FreeSpaceMapPage *FetchMapPage(page_id_t page_id);
+
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t first_page_id_;
+  page_id_t last_map_page_id_;
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  std::mutex latch_;
+  std::unordered_map<page_id_t, Entry> entries_;
+  std::array<std::set<page_id_t>, FSM_BUCKETS> buckets_;  // table pages of each class
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_H
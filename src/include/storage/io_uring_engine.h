@@ -0,0 +1,74 @@
+#ifndef MINISQL_IO_URING_ENGINE_H
+#define MINISQL_IO_URING_ENGINE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * IoUringEngine submits reads and writes of a file descriptor through an io_uring and runs a callback on completion.
+ *
+ * The ring is driven by raw system calls, so no library is needed. Submissions come from any thread and block only
+ * when queue depth I/Os are already in flight; a single completion thread reaps the completion queue and runs the
+ * callbacks, which must therefore be short and must not submit I/O and wait for it.
+ */
+class IoUringEngine {
+ public:
+  /** Called with the number of bytes transferred, or -errno. */
+  using Callback = std::function<void(int result)>;
+
+  /**
+   * @return a new engine, or null if the kernel does not offer io_uring (too old, or forbidden by a sandbox)
+   */
+  static std::unique_ptr<IoUringEngine> Create(unsigned queue_depth);
+
+  /**
+   * Wait for the I/Os in flight, stop the completion thread and release the ring.
+   */
+  ~IoUringEngine();
+
+  void Read(int fd, char *data, uint32_t size, int64_t offset, Callback done);
+
+  void Write(int fd, const char *data, uint32_t size, int64_t offset, Callback done);
+
+ private:
+  IoUringEngine() = default;
+
+  bool Setup(unsigned queue_depth);
+
+  void Submit(uint8_t opcode, int fd, const void *data, uint32_t size, int64_t offset, Callback done);
+
+  void CompletionLoop();
+
+  int ring_fd_{-1};
+  // mappings of the submission queue, the completion queue and the submission entries
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+  // pointers into the rings
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+
+  std::mutex latch_;                 // protects the submission queue and the slots
+  std::condition_variable slot_cv_;  // signalled when a slot is freed
+  std::vector<Callback> callbacks_;  // callback of the I/O of each slot, user_data of an entry is its slot + 1
+  std::vector<unsigned> free_slots_;
+  std::thread completion_thread_;
+};
+
+#endif  // MINISQL_IO_URING_ENGINE_H
@@ -6,23 +6,32 @@
 #include "page/header_page.h"
 #include "page/table_page.h"
 #include "recovery/log_manager.h"
+#include "storage/free_space_map.h"
 #include "storage/table_iterator.h"
 
 class TableHeap {
   friend class TableIterator;
 
  public:
+  /**
+   * @param data_file data file of the tablespace the pages of the table are allocated in
+   */
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Txn *txn, LogManager *log_manager,
-                           LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
+                           LockManager *lock_manager, uint32_t data_file = 0) {
+    return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager, data_file);
   }
 
+  /**
+   * Open a table, its pages keep being allocated in the data file of its first page.
+   * @param fsm_page_id first page of the free-space map of the table, INVALID_PAGE_ID to build one from its pages
+   */
+
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+                           LogManager *log_manager, LockManager *lock_manager, page_id_t fsm_page_id = INVALID_PAGE_ID) {
+    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager, fsm_page_id);
   }
 
-  ~TableHeap() {}
+  ~TableHeap() { ReleaseUnusedPages(); }
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
@@ -32,6 +41,15 @@ class TableHeap {
    */
   bool InsertTuple(Row &row, Txn *txn);
 
+  /**
+   * Append rows at the end of the table: the last page stays pinned while it is filled, then the next one is chained
+   * to it. Pages with room elsewhere in the table are not looked at.
+   * @param[in/out] rows Rows to insert, the rid of each inserted row is wrapped in it
+   * @param[in] txn The recovery performing the insert
+   * @return the number of rows inserted, the rows after them are not in the table
+   */
+  size_t BulkInsert(std::vector<Row> &rows, Txn *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param[in] rid Resource id of the tuple of delete
@@ -75,23 +93,31 @@ class TableHeap {
     auto next_page_id = first_page_id_;
     while (next_page_id != INVALID_PAGE_ID) {
       auto old_page_id = next_page_id;
-      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(old_page_id));
+      auto page = FetchTablePage(old_page_id);
       assert(page != nullptr);
       next_page_id = page->GetNextPageId();
       buffer_pool_manager_->UnpinPage(old_page_id, false);
       buffer_pool_manager_->DeletePage(old_page_id);
     }
+    ReleaseUnusedPages();
+    fsm_.Destroy();
   }
 
+  /**
+   * Give back the pages reserved for the table to grow into but not used yet, e.g. once it is rebuilt.
+   */
+  void ReleaseUnusedPages() { buffer_pool_manager_->ReleaseExtents(extents_); }
+
   /**
    * Free table heap and release storage in disk file
    */
   void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
 
   /**
+   * @param strategy ring the scan reads the table through, null to use the buffer pool normally
    * @return the begin iterator of this table
    */
-  TableIterator Begin(Txn *txn);
+  TableIterator Begin(Txn *txn, BufferAccessStrategy *strategy = nullptr);
 
   /**
    * @return the end iterator of this table
@@ -103,30 +129,65 @@ class TableHeap {
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the id of the first page of the free-space map of this table
+   */
+  inline page_id_t GetFreeSpaceMapPageId() const { return fsm_.GetFirstPageId(); }
+
+  /**
+   * @param distance pages iterators read ahead of themselves, 0 turns read-ahead off
+   */
+  inline void SetPrefetchDistance(int distance) { prefetch_distance_ = distance; }
+
  private:
+  /**
+   * Pin a page of the table and tag it as a table page for the buffer pool statistics.
+   * @return nullptr if the page could not be pinned
+   */
+  TablePage *FetchTablePage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, strategy));
+    if (page != nullptr) {
+      page->SetPageType(PageType::kTable);
+    }
+    return page;
+  }
+
   /**
    * create table heap and initialize first page
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Txn *txn, LogManager *log_manager,
-                     LockManager *lock_manager)
+                     LockManager *lock_manager, uint32_t data_file)
       : buffer_pool_manager_(buffer_pool_manager),
         schema_(schema),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {
-        auto page=reinterpret_cast<TablePage *>(buffer_pool_manager->NewPage(first_page_id_));
+        lock_manager_(lock_manager),
+        extents_(EXTENT_RUN_SIZE, data_file),
+        fsm_(buffer_pool_manager, INVALID_PAGE_ID, data_file) {
+        auto page=reinterpret_cast<TablePage *>(buffer_pool_manager->NewPage(first_page_id_, &extents_));
         page->Init(first_page_id_,INVALID_PAGE_ID,log_manager,txn);
         page->SetNextPageId(INVALID_PAGE_ID);
+        fsm_.AddPage(first_page_id_, page->GetFreeSpaceRemaining());
         buffer_pool_manager->UnpinPage(first_page_id_,true);
     ;
   };
 
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+                     LogManager *log_manager, LockManager *lock_manager, page_id_t fsm_page_id)
       : buffer_pool_manager_(buffer_pool_manager),
         first_page_id_(first_page_id),
         schema_(schema),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {}
+        lock_manager_(lock_manager),
+        extents_(EXTENT_RUN_SIZE, DiskManager::DataFileOf(first_page_id)),
+        fsm_(buffer_pool_manager, fsm_page_id, DiskManager::DataFileOf(first_page_id)) {
+    BuildFreeSpaceMap();
+  }
+
+  /**
+   * Record the pages of the table its free-space map is missing: all of them for a table written before it had one,
+   * else those after the last page of the map, which a map that could not grow left out.
+   */
+  void BuildFreeSpaceMap();
 
  private:
   BufferPoolManager *buffer_pool_manager_;
@@ -134,6 +195,9 @@ class TableHeap {
   Schema *schema_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
+  int prefetch_distance_{PREFETCH_DISTANCE};
+  ExtentAllocator extents_;  // the pages of the table follow each other in the file
+  FreeSpaceMap fsm_;         // pages with room for a row, so that inserts do not walk the chain
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
@@ -1,19 +1,35 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/read_ahead_window.h"
 #include "common/rowid.h"
 #include "concurrency/txn.h"
 #include "record/row.h"
+#include "record/row_view.h"
 
 class TableHeap;
+class TablePage;
 
+/**
+ * TableIterator walks the rows of a table heap a page at a time.
+ *
+ * The page of the current row stays pinned while the iterator is on it, the slots of the page are read in place and
+ * the page is only unpinned when the iterator moves to the next one or goes away. The current row is decoded on the
+ * first dereference into a row owned by the iterator, which is valid until the iterator moves.
+ */
 class TableIterator {
 public:
- // you may define your own constructor based on your member variables
- explicit TableIterator(TableHeap *table_heap, RowId rid, Txn *txn);
+ /**
+  * @param rid the iterator starts at the first row at or after rid, INVALID_PAGE_ID for the end iterator
+  */
+ explicit TableIterator(TableHeap *table_heap, RowId rid, Txn *txn, BufferAccessStrategy *strategy = nullptr);
 
+ /** A copy pins the page of the row again. */
  explicit TableIterator(const TableIterator &other);
 
+ TableIterator(TableIterator &&other) noexcept;
+
   virtual ~TableIterator();
 
   bool operator==(const TableIterator &itr) const;
@@ -24,17 +40,46 @@ public:
 
   Row *operator->();
 
+  /**
+   * @return the current row read in place in the pinned page, valid until the iterator moves
+   */
+  const RowView &GetRowView();
+
+  /**
+   * Move to a row, e.g. one found in an index. The page is kept pinned if the row is in it, so that rows visited in
+   * page order fetch each page once.
+   * @return false if the row does not exist, the iterator must not be dereferenced then
+   */
+  bool Seek(const RowId &rid);
+
   TableIterator &operator=(const TableIterator &itr) noexcept;
 
+  TableIterator &operator=(TableIterator &&itr) noexcept;
+
   TableIterator &operator++();
 
+  /** Prefer ++iter, the copy returned here pins a page of its own. */
   TableIterator operator++(int);
 
 private:
+  /**
+   * Move on from the pinned page until a page has a row, unpinning the pages left behind.
+   * @param found rid_ already is a row of the pinned page
+   */
+  void FindRow(bool found);
+
+  /** Unpin the page and become the end iterator, the table is kept for Seek. */
+  void Reset();
+
   TableHeap *table_heap_;
   RowId rid_;
   Txn *txn_;
-  // add your own private member variables here
+  BufferAccessStrategy *strategy_;  // ring the pages of the scan are read through, may be null
+  ReadAheadWindow read_ahead_;      // pages of the chain requested ahead of rid_
+  TablePage *page_{nullptr};        // page of rid_, pinned while the iterator is on it
+  Row row_;                         // row at rid_, decoded on the first dereference
+  bool row_loaded_{false};
+  RowView view_;                    // row at rid_ in place
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
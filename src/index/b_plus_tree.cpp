@@ -11,14 +11,17 @@
  * TODO: Student Implement
  */
 BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &KM,
-                     int leaf_max_size, int internal_max_size)
+                     int leaf_max_size, int internal_max_size, uint32_t data_file)
     : index_id_(index_id),
       buffer_pool_manager_(buffer_pool_manager),
       processor_(KM),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {
+      internal_max_size_(internal_max_size),
+      leaf_extents_(EXTENT_RUN_SIZE, data_file),
+      internal_extents_(EXTENT_RUN_SIZE, data_file) {
     root_page_id_ = INVALID_PAGE_ID;
     Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+    page->SetPageType(PageType::kCatalog);
     IndexRootsPage *index_roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
     if (!index_roots_page->GetRootId(index_id, &root_page_id_)) {
       root_page_id_ = INVALID_PAGE_ID;
@@ -29,28 +32,38 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
     internal_max_size_ = INTERNAL_PAGE_SIZE;
 }
 
+BPlusTree::~BPlusTree() { ReleaseUnusedPages(); }
+
+void BPlusTree::ReleaseUnusedPages() {
+  buffer_pool_manager_->ReleaseExtents(leaf_extents_);
+  buffer_pool_manager_->ReleaseExtents(internal_extents_);
+}
+
 void BPlusTree::Destroy(page_id_t current_page_id) {
  if(current_page_id == INVALID_PAGE_ID) {
     current_page_id = root_page_id_;
   }
-    Page* page = buffer_pool_manager_->FetchPage(current_page_id);
+  // an empty tree has no node, only its entry in the index roots page
+  if(current_page_id != INVALID_PAGE_ID) {
+    Page* page = FetchNode(current_page_id);
     BPlusTreePage* node = reinterpret_cast<BPlusTreePage*>(page->GetData());
-    if(node->IsLeafPage()) {
-      buffer_pool_manager_->DeletePage(current_page_id);
-      buffer_pool_manager_->UnpinPage(current_page_id, true);
-    }else{
+    if(!node->IsLeafPage()) {
       InternalPage* internal = reinterpret_cast<InternalPage*>(node);
       for(int i = 0; i < internal->GetSize(); i++) {
         Destroy(internal->ValueAt(i));
       }
-      buffer_pool_manager_->DeletePage(current_page_id);
-      buffer_pool_manager_->UnpinPage(current_page_id, true);
+    }
+    // a pinned page is not deleted, unpin it first
+    buffer_pool_manager_->UnpinPage(current_page_id, false);
+    buffer_pool_manager_->DeletePage(current_page_id);
   }
   if(current_page_id == root_page_id_) {
     auto head = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+    head->SetPageType(PageType::kCatalog);
     IndexRootsPage* index_roots_page = reinterpret_cast<IndexRootsPage*>(head->GetData());
     index_roots_page->Delete(index_id_);
     buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+    root_page_id_ = INVALID_PAGE_ID;
   }
 }
 
@@ -116,10 +129,11 @@ bool BPlusTree::Insert(GenericKey *key, const RowId &value, Txn *transaction) {
  * tree's root page id and insert entry directly into leaf page.
  */
 void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
-  Page *page = buffer_pool_manager_->NewPage(root_page_id_);
+  Page *page = buffer_pool_manager_->NewPage(root_page_id_, &leaf_extents_);
   ASSERT(page != nullptr, "out of memory");
   LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
   leaf_page->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
+  page->SetPageType(PageType::kIndexLeaf);
   leaf_page->Insert(key, value, processor_);
   buffer_pool_manager_->UnpinPage(root_page_id_, true);
   UpdateRootPageId(0);
@@ -179,10 +193,11 @@ bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transac
  */
 BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Txn *transaction) {
   page_id_t new_page_id;
-  Page *page = buffer_pool_manager_->NewPage(new_page_id);
+  Page *page = buffer_pool_manager_->NewPage(new_page_id, &internal_extents_);
   ASSERT(page != nullptr, "out of memory");
   InternalPage *new_internal_page = reinterpret_cast<InternalPage *>(page->GetData());
   new_internal_page->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), internal_max_size_);
+  page->SetPageType(PageType::kIndexInternal);
   node->MoveHalfTo(new_internal_page, buffer_pool_manager_);
   // buffer_pool_manager_->UnpinPage(new_page_id, true);
   return new_internal_page;
@@ -190,10 +205,11 @@ BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Txn *transaction) {
 
 BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Txn *transaction) {
   page_id_t new_page_id;
-  Page *page = buffer_pool_manager_->NewPage(new_page_id);
+  Page *page = buffer_pool_manager_->NewPage(new_page_id, &leaf_extents_);
   ASSERT(page != nullptr, "out of memory");
   LeafPage *new_leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
   new_leaf_page->Init(new_page_id, node->GetParentPageId(), processor_.GetKeySize(), leaf_max_size_);
+  page->SetPageType(PageType::kIndexLeaf);
   node->MoveHalfTo(new_leaf_page);
   new_leaf_page->SetNextPageId(node->GetNextPageId());
   node->SetNextPageId(new_page_id);
@@ -212,10 +228,11 @@ BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Txn *transaction) {
 void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node, Txn *transaction) {
   if(old_node->IsRootPage()) {
     page_id_t new_page_id;
-    Page *page = buffer_pool_manager_->NewPage(new_page_id);
+    Page *page = buffer_pool_manager_->NewPage(new_page_id, &internal_extents_);
     ASSERT(page != nullptr, "out of memory"); 
     InternalPage *new_root_node = reinterpret_cast<InternalPage *>(page->GetData());
     new_root_node->Init(new_page_id, INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_);
+    page->SetPageType(PageType::kIndexInternal);
     new_root_node->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
     old_node->SetParentPageId(new_page_id);
     new_node->SetParentPageId(new_page_id);
@@ -224,7 +241,7 @@ void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlus
     buffer_pool_manager_->UnpinPage(new_page_id, true);
   }else{
     page_id_t page_id = old_node->GetParentPageId();
-    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    Page *page = FetchNode(page_id);
     InternalPage *parent_node = reinterpret_cast<InternalPage *>(page->GetData());
     if(parent_node->GetSize() < parent_node->GetMaxSize()) {
       parent_node->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
@@ -287,17 +304,21 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
   if (node->IsRootPage()) {
     return AdjustRoot(node);
   }
-  auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
+  auto parent = reinterpret_cast<InternalPage *>(FetchNode(node->GetParentPageId())->GetData());
   int index = parent->ValueIndex(node->GetPageId());
   page_id_t sibilings = index == 0 ? parent->ValueAt(1) : parent->ValueAt(index - 1);
-  auto sibilings_page = reinterpret_cast<N *>(buffer_pool_manager_->FetchPage(sibilings)->GetData());
+  auto sibilings_page = reinterpret_cast<N *>(FetchNode(sibilings)->GetData());
+  // the caller holds the pin of node, the parent and the sibling are unpinned here
   if(node->GetSize() + sibilings_page->GetSize() > node->GetMaxSize()) {
     Redistribute(sibilings_page, node, index);
     buffer_pool_manager_->UnpinPage(sibilings_page->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
+    buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
     return false;
   }else{
-    if(Coalesce(sibilings_page, node, parent, index, transaction)) {
+    // node is the emptied page afterwards, a merge into the first child swaps it with the sibling
+    bool parent_underflow = Coalesce(sibilings_page, node, parent, index, transaction);
+    buffer_pool_manager_->UnpinPage(sibilings_page->GetPageId(), true);
+    if(parent_underflow) {
       if(parent->IsRootPage()) {
         if(AdjustRoot(parent)) {
           buffer_pool_manager_->UnpinPage(parent->GetPageId(), false);
@@ -368,7 +389,7 @@ bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, Inte
  * @param   node               input from method coalesceOrRedistribute()
  */
 void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index) {
-  auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
+  auto parent = reinterpret_cast<InternalPage *>(FetchNode(node->GetParentPageId())->GetData());
   if(index == 0){
     neighbor_node->MoveFirstToEndOf(node);
     parent->SetKeyAt(1, neighbor_node->KeyAt(0));
@@ -379,7 +400,7 @@ void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index)
   buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
 }
 void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, int index) {
-  auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
+  auto parent = reinterpret_cast<InternalPage *>(FetchNode(node->GetParentPageId())->GetData());
   if(index == 0){
     neighbor_node->MoveFirstToEndOf(node, parent->KeyAt(1), buffer_pool_manager_);
     parent->SetKeyAt(1, neighbor_node->KeyAt(0));
@@ -404,7 +425,7 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
   if(old_root_node->GetSize() == 1 && !old_root_node->IsLeafPage()){
     InternalPage *old_page = reinterpret_cast<InternalPage *>(old_root_node);
     page_id_t child_page_id = old_page->RemoveAndReturnOnlyChild();
-    Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
+    Page *child_page = FetchNode(child_page_id);
     BPlusTreePage *child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
     child_node->SetParentPageId(INVALID_PAGE_ID);
     root_page_id_ = child_page_id;
@@ -431,15 +452,15 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
  */
 IndexIterator BPlusTree::Begin() {
   page_id_t page_id = root_page_id_;
-  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  Page *page = FetchNode(page_id);
   BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
   while(!node->IsLeafPage()) {
     InternalPage *internal_node = reinterpret_cast<InternalPage *>(node);
     page_id = internal_node->ValueAt(0);
     buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
-    node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    node = reinterpret_cast<BPlusTreePage *>(FetchNode(page_id)->GetData());
   }
-  return IndexIterator(page_id, buffer_pool_manager_);
+  return IndexIterator(page_id, buffer_pool_manager_, 0, prefetch_distance_);
 }
 
 /*
@@ -455,7 +476,7 @@ IndexIterator BPlusTree::Begin(const GenericKey *key) {
   LeafPage *node = reinterpret_cast<LeafPage *>(page->GetData());
   int index = node->KeyIndex(key, processor_);
   buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
-  return IndexIterator(node->GetPageId(), buffer_pool_manager_, index);
+  return IndexIterator(node->GetPageId(), buffer_pool_manager_, index, prefetch_distance_);
 }
 
 /*
@@ -479,7 +500,7 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
   if(page_id == INVALID_PAGE_ID){
     return FindLeafPage(key, root_page_id_, leftMost);
   }
-  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  Page *page = FetchNode(page_id);
   auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
   if(node->IsLeafPage()) {
     return page;
@@ -502,6 +523,7 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
  */
 void BPlusTree::UpdateRootPageId(int insert_record) {
   auto* page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  page->SetPageType(PageType::kCatalog);
   auto* index_roots_page = reinterpret_cast<IndexRootsPage*>(page->GetData());
   if (insert_record) {
     index_roots_page->Insert(index_id_, root_page_id_);
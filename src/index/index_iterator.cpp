@@ -5,10 +5,20 @@
 
 IndexIterator::IndexIterator() = default;
 
-IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
-    : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) {
-      if(current_page_id != INVALID_PAGE_ID)
-        page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
+static page_id_t NextLeafPageId(Page *page) {
+  return reinterpret_cast<BPlusTreeLeafPage *>(page->GetData())->GetNextPageId();
+}
+
+IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index, int prefetch_distance)
+    : current_page_id(page_id),
+      item_index(index),
+      buffer_pool_manager(bpm),
+      read_ahead(bpm, NextLeafPageId, prefetch_distance) {
+      if(current_page_id != INVALID_PAGE_ID) {
+        page = reinterpret_cast<LeafPage *>(
+            BPlusTreePage::TagPage(buffer_pool_manager->FetchPage(current_page_id))->GetData());
+        read_ahead.Advance(current_page_id);
+      }
 }
 
 IndexIterator::~IndexIterator() {
@@ -28,8 +38,10 @@ IndexIterator &IndexIterator::operator++() {
     buffer_pool_manager->UnpinPage(current_page_id, false);
     current_page_id = next_page_id;
     if (current_page_id != INVALID_PAGE_ID) {
-      page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
+      page = reinterpret_cast<LeafPage *>(
+          BPlusTreePage::TagPage(buffer_pool_manager->FetchPage(current_page_id))->GetData());
       item_index = 0;
+      read_ahead.Advance(current_page_id);
     } else{
       page = nullptr;
       current_page_id = INVALID_PAGE_ID;
@@ -148,7 +148,7 @@ void InternalPage::CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool
   for(int i = old_size; i < size; ++i)
   {
     page_id_t page_id = ValueAt(i);
-    auto *page = buffer_pool_manager->FetchPage(page_id);
+    auto *page = TagPage(buffer_pool_manager->FetchPage(page_id));
     ASSERT(page != nullptr, "page is nullptr");
     auto *internal_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
     internal_page->SetParentPageId(GetPageId());
@@ -201,7 +201,7 @@ void InternalPage::MoveAllTo(InternalPage *recipient, GenericKey *middle_key, Bu
   for(int i = 0; i < size; ++i)
   {
     page_id_t page_id = ValueAt(i);
-    auto *page = buffer_pool_manager->FetchPage(page_id);
+    auto *page = TagPage(buffer_pool_manager->FetchPage(page_id));
     ASSERT(page != nullptr, "page is nullptr");
     auto *internal_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
     internal_page->SetParentPageId(recipient->GetPageId());
@@ -245,7 +245,7 @@ void InternalPage::CopyLastFrom(GenericKey *key, const page_id_t value, BufferPo
   SetKeyAt(size, key);
   SetValueAt(size, value);
   IncreaseSize(1);
-  auto *page = buffer_pool_manager->FetchPage(value);
+  auto *page = TagPage(buffer_pool_manager->FetchPage(value));
   ASSERT(page != nullptr, "page is nullptr");
   auto *internal_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
   internal_page->SetParentPageId(GetPageId());
@@ -277,7 +277,7 @@ void InternalPage::CopyFirstFrom(const page_id_t value, BufferPoolManager *buffe
   }
   SetValueAt(0, value);
   IncreaseSize(1);
-  auto *page = buffer_pool_manager->FetchPage(value);
+  auto *page = TagPage(buffer_pool_manager->FetchPage(value));
   ASSERT(page != nullptr, "page is nullptr");
   auto *internal_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
   internal_page->SetParentPageId(GetPageId());
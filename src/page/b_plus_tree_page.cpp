@@ -107,4 +107,12 @@ void BPlusTreePage::SetPageId(page_id_t page_id) {
  */
 void BPlusTreePage::SetLSN(lsn_t lsn) {
   lsn_ = lsn;
-}
\ No newline at end of file
+}
+
+Page *BPlusTreePage::TagPage(Page *page) {
+  if (page != nullptr) {
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    page->SetPageType(node->IsLeafPage() ? PageType::kIndexLeaf : PageType::kIndexInternal);
+  }
+  return page;
+}
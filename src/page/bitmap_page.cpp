@@ -1,5 +1,7 @@
 #include "page/bitmap_page.h"
 
+#include <cstring>
+
 #include "glog/logging.h"
 
 // 每个page的信息存储在一个bit中，page_offset是具体哪一位的索引，而存储结构是一个char数组
@@ -7,22 +9,85 @@
  * TODO: Student Implement
  */
 template <size_t PageSize>
-bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) { 
-  if(IsPageFree(next_free_page_)){
-    bytes[next_free_page_ / 8] |= (1 << (next_free_page_ % 8)); // 把指定位设为1
-    page_offset = next_free_page_;
-    page_allocated_++;
-    uint32_t free_index = 0;
-    while (!IsPageFree(free_index) && free_index < GetMaxSupportedSize() - 1)
-    {
-      free_index++;
+bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
+  if (page_allocated_ >= GetMaxSupportedSize()) {
+    return false;
+  }
+  // the hint is the lowest free page, unless the bitmap was written by an older version that did not keep it so
+  uint32_t offset = next_free_page_;
+  if ((offset >= GetMaxSupportedSize() || !IsPageFreeLow(offset / 8, offset % 8)) && !FindPage(0, true, offset)) {
+    return false;
+  }
+  bytes[offset / 8] |= (1 << (offset % 8));
+  page_allocated_++;
+  page_offset = offset;
+  // every page below this one is in use, so the next free one is after it
+  if (!FindPage(offset + 1, true, next_free_page_)) {
+    next_free_page_ = GetMaxSupportedSize();
+  }
+  return true;
+}
+
+template <size_t PageSize>
+bool BitmapPage<PageSize>::AllocateRun(uint32_t num_pages, uint32_t &page_offset) {
+  if (num_pages == 0 || page_allocated_ + num_pages > GetMaxSupportedSize()) {
+    return false;
+  }
+  // first fit: from every free page, the run ends at the next page in use
+  uint32_t begin = next_free_page_;
+  while (begin < GetMaxSupportedSize() && FindPage(begin, true, begin)) {
+    uint32_t end;
+    if (!FindPage(begin, false, end)) {
+      end = GetMaxSupportedSize();
     }
-    next_free_page_ = free_index;
-    return true;
+    if (end - begin >= num_pages) {
+      for (uint32_t offset = begin; offset < begin + num_pages; offset++) {
+        bytes[offset / 8] |= (1 << (offset % 8));
+      }
+      page_allocated_ += num_pages;
+      page_offset = begin;
+      if (begin <= next_free_page_ && !FindPage(begin + num_pages, true, next_free_page_)) {
+        next_free_page_ = GetMaxSupportedSize();
+      }
+      return true;
+    }
+    begin = end;
   }
   return false;
 }
 
+template <size_t PageSize>
+bool BitmapPage<PageSize>::AllocatePageAt(uint32_t page_offset) {
+  if (!IsPageFree(page_offset)) {
+    return false;
+  }
+  bytes[page_offset / 8] |= (1 << (page_offset % 8));
+  page_allocated_++;
+  if (page_offset == next_free_page_ && !FindPage(page_offset + 1, true, next_free_page_)) {
+    next_free_page_ = GetMaxSupportedSize();
+  }
+  return true;
+}
+
+template <size_t PageSize>
+bool BitmapPage<PageSize>::FindPage(uint32_t from, bool is_free, uint32_t &page_offset) const {
+  static_assert(MAX_CHARS % sizeof(uint64_t) == 0, "The bitmap is scanned a word at a time.");
+  static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Page i is bit i % 64 of word i / 64.");
+  constexpr uint32_t num_words = MAX_CHARS / sizeof(uint64_t);
+  for (uint32_t word_index = from / 64; word_index < num_words; word_index++) {
+    uint64_t word;
+    memcpy(&word, bytes + word_index * sizeof(uint64_t), sizeof(uint64_t));
+    uint64_t bits = is_free ? ~word : word;
+    if (word_index == from / 64) {
+      bits &= ~static_cast<uint64_t>(0) << (from % 64);
+    }
+    if (bits != 0) {
+      page_offset = word_index * 64 + __builtin_ctzll(bits);
+      return true;
+    }
+  }
+  return false;
+}
 
 /**
  * TODO: Student Implement
@@ -53,6 +118,19 @@ bool BitmapPage<PageSize>::IsPageFree(uint32_t page_offset) const {
   return IsPageFreeLow(page_offset / 8, page_offset % 8);
 }
 
+template <size_t PageSize>
+uint32_t BitmapPage<PageSize>::GetUsedEnd() const {
+  uint32_t byte_index = MAX_CHARS;
+  while (byte_index > 0 && bytes[byte_index - 1] == 0) {
+    byte_index--;
+  }
+  if (byte_index == 0) {
+    return 0;
+  }
+  // one past the highest bit set in the last used byte
+  return (byte_index - 1) * 8 + 32 - __builtin_clz(bytes[byte_index - 1]);
+}
+
 template <size_t PageSize>
 bool BitmapPage<PageSize>::IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const {
   return (bytes[byte_index] & (1 << bit_index)) == 0;
@@ -1,6 +1,7 @@
 #include "parser/parser.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #include "parser/syntax_tree.h"
 
@@ -71,4 +72,15 @@ int MinisqlParserGetError() {
 
 char *MinisqlParserGetErrorMessage() {
   return minisql_parser_error_message_;
-}
\ No newline at end of file
+}
+
+int MinisqlParserIsVariable(const char *name) {
+  static const char *variables[] = {"buffer_pool_size", "compressed_cache_size", "page_trace",
+                                    "page_compression", "data_files",            "data_file"};
+  for (size_t i = 0; i < sizeof(variables) / sizeof(variables[0]); i++) {
+    if (strcmp(name, variables[i]) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
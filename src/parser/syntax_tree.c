@@ -170,6 +170,12 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeSet:
+      return "kNodeSet";
+    case kNodeShowStatus:
+      return "kNodeShowStatus";
+    case kNodeVacuum:
+      return "kNodeVacuum";
     default:
       return "error type";
   }
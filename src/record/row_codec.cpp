@@ -0,0 +1,173 @@
+#include "record/row_codec.h"
+
+RowCodec::RowCodec(const std::vector<Column *> &columns) {
+  // the fields of a row follow its field count and null bitmap, null fields take no space
+  header_size_ = sizeof(uint32_t) + (columns.size() + 7) / 8;
+  uint32_t offset = header_size_;
+  types_.reserve(columns.size());
+  fixed_offsets_.reserve(columns.size());
+  for (auto column : columns) {
+    types_.push_back(column->GetType());
+    fixed_offsets_.push_back(offset);
+    if (column->GetType() == TypeId::kTypeChar) {
+      offset = VARIABLE_OFFSET;
+    } else if (offset != VARIABLE_OFFSET) {
+      offset += Type::GetTypeSize(column->GetType());
+    }
+  }
+  fixed_width_ = offset != VARIABLE_OFFSET;
+  fixed_size_ = fixed_width_ ? offset : 0;
+}
+
+uint32_t RowCodec::SerializeTo(const std::vector<Field *> &fields, char *buf) const {
+  uint32_t field_count = fields.size();
+  memcpy(buf, &field_count, sizeof(uint32_t));
+  char *null_bitmap = buf + sizeof(uint32_t);
+  memset(null_bitmap, 0, header_size_ - sizeof(uint32_t));
+  bool has_null = false;
+  for (uint32_t i = 0; i < field_count; i++) {
+    if (fields[i]->is_null_) {
+      null_bitmap[i / 8] |= (1 << (i % 8));
+      has_null = true;
+    }
+  }
+  if (fixed_width_ && !has_null) {
+    // int and float both take the first four bytes of the value
+    for (uint32_t i = 0; i < field_count; i++) {
+      memcpy(buf + fixed_offsets_[i], &fields[i]->value_, sizeof(int32_t));
+    }
+    return fixed_size_;
+  }
+  uint32_t offset = header_size_;
+  for (uint32_t i = 0; i < field_count; i++) {
+    if (!fields[i]->is_null_) {
+      offset += WriteField(fields[i]->type_id_, *fields[i], buf + offset);
+    }
+  }
+  return offset;
+}
+
+uint32_t RowCodec::DeserializeFrom(const char *buf, std::vector<Field *> &fields) const {
+  uint32_t field_count = MACH_READ_UINT32(buf);
+  ASSERT(field_count == types_.size(), "Field count does not match the schema.");
+  const char *null_bitmap = buf + sizeof(uint32_t);
+  uint32_t offset = header_size_;
+  for (uint32_t i = 0; i < field_count; i++) {
+    Field *field;
+    if (null_bitmap[i / 8] & (1 << (i % 8))) {
+      field = new Field(types_[i]);
+    } else {
+      offset += ReadField(types_[i], buf + offset, &field);
+    }
+    fields.push_back(field);
+  }
+  return offset;
+}
+
+uint32_t RowCodec::GetSerializedSize(const std::vector<Field *> &fields) const {
+  uint32_t size = header_size_;
+  bool has_null = false;
+  for (auto field : fields) {
+    if (field->is_null_) {
+      has_null = true;
+    } else {
+      size += GetFieldSize(field->type_id_, *field);
+    }
+  }
+  return fixed_width_ && !has_null ? fixed_size_ : size;
+}
+
+template <>
+uint32_t RowCodec::WriteField<TypeId::kTypeInt>(const Field &field, char *buf) {
+  MACH_WRITE_TO(int32_t, buf, field.value_.integer_);
+  return sizeof(int32_t);
+}
+
+template <>
+uint32_t RowCodec::WriteField<TypeId::kTypeFloat>(const Field &field, char *buf) {
+  MACH_WRITE_TO(float, buf, field.value_.float_);
+  return sizeof(float);
+}
+
+template <>
+uint32_t RowCodec::WriteField<TypeId::kTypeChar>(const Field &field, char *buf) {
+  MACH_WRITE_UINT32(buf, field.len_);
+  memcpy(buf + sizeof(uint32_t), field.value_.chars_, field.len_);
+  return sizeof(uint32_t) + field.len_;
+}
+
+template <>
+uint32_t RowCodec::ReadField<TypeId::kTypeInt>(const char *buf, Field **field) {
+  *field = new Field(TypeId::kTypeInt, MACH_READ_INT32(buf));
+  return sizeof(int32_t);
+}
+
+template <>
+uint32_t RowCodec::ReadField<TypeId::kTypeFloat>(const char *buf, Field **field) {
+  *field = new Field(TypeId::kTypeFloat, MACH_READ_FROM(float, buf));
+  return sizeof(float);
+}
+
+template <>
+uint32_t RowCodec::ReadField<TypeId::kTypeChar>(const char *buf, Field **field) {
+  uint32_t len = MACH_READ_UINT32(buf);
+  *field = new Field(TypeId::kTypeChar, const_cast<char *>(buf) + sizeof(uint32_t), len, true);
+  return sizeof(uint32_t) + len;
+}
+
+template <>
+uint32_t RowCodec::GetFieldSize<TypeId::kTypeInt>([[maybe_unused]] const Field &field) {
+  return sizeof(int32_t);
+}
+
+template <>
+uint32_t RowCodec::GetFieldSize<TypeId::kTypeFloat>([[maybe_unused]] const Field &field) {
+  return sizeof(float);
+}
+
+template <>
+uint32_t RowCodec::GetFieldSize<TypeId::kTypeChar>(const Field &field) {
+  return sizeof(uint32_t) + field.len_;
+}
+
+uint32_t RowCodec::WriteField(TypeId type, const Field &field, char *buf) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return WriteField<TypeId::kTypeInt>(field, buf);
+    case TypeId::kTypeFloat:
+      return WriteField<TypeId::kTypeFloat>(field, buf);
+    case TypeId::kTypeChar:
+      return WriteField<TypeId::kTypeChar>(field, buf);
+    default:
+      ASSERT(false, "Unsupported field type.");
+      return 0;
+  }
+}
+
+uint32_t RowCodec::ReadField(TypeId type, const char *buf, Field **field) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return ReadField<TypeId::kTypeInt>(buf, field);
+    case TypeId::kTypeFloat:
+      return ReadField<TypeId::kTypeFloat>(buf, field);
+    case TypeId::kTypeChar:
+      return ReadField<TypeId::kTypeChar>(buf, field);
+    default:
+      ASSERT(false, "Unsupported field type.");
+      return 0;
+  }
+}
+
+uint32_t RowCodec::GetFieldSize(TypeId type, const Field &field) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return GetFieldSize<TypeId::kTypeInt>(field);
+    case TypeId::kTypeFloat:
+      return GetFieldSize<TypeId::kTypeFloat>(field);
+    case TypeId::kTypeChar:
+      return GetFieldSize<TypeId::kTypeChar>(field);
+    default:
+      ASSERT(false, "Unsupported field type.");
+      return 0;
+  }
+}
@@ -0,0 +1,95 @@
+#include "record/row_view.h"
+
+Field RowView::GetField(uint32_t column_index) const {
+  TypeId type = schema_->GetColumn(column_index)->GetType();
+  if (IsNull(column_index)) {
+    return Field(type);
+  }
+  const char *value = data_ + GetOffset(column_index);
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, MACH_READ_FROM(int32_t, value));
+    case TypeId::kTypeFloat:
+      return Field(type, MACH_READ_FROM(float, value));
+    default:
+      return Field(type, const_cast<char *>(value) + sizeof(uint32_t), MACH_READ_UINT32(value), false);
+  }
+}
+
+void RowView::GetRow(Row *row) const {
+  row->destroy();
+  row->SetRowId(rid_);
+  for (uint32_t i = 0; i < GetFieldCount(); i++) {
+    row->GetFields().push_back(NewField(i));
+  }
+}
+
+void RowView::GetRow(const std::vector<uint32_t> &column_indexes, Row *row) const {
+  row->destroy();
+  row->SetRowId(rid_);
+  for (auto i : column_indexes) {
+    row->GetFields().push_back(NewField(i));
+  }
+}
+
+uint32_t RowView::GetSerializedSize() const {
+  uint32_t column_count = GetFieldCount();
+  if (column_count == 0) {
+    return schema_->GetRowHeaderSize();
+  }
+  uint32_t offset = GetOffset(column_count - 1);
+  return offset + GetStoredSize(column_count - 1, offset);
+}
+
+uint32_t RowView::GetOffset(uint32_t column_index) const {
+  uint32_t offset = schema_->GetFixedOffset(column_index);
+  if (offset != Schema::VARIABLE_OFFSET && !HasNullBefore(column_index)) {
+    return offset;
+  }
+  // columns are mostly read left to right, a walk goes on from where the last one stopped
+  if (walked_column_ > column_index) {
+    walked_column_ = 0;
+    walked_offset_ = schema_->GetRowHeaderSize();
+  }
+  for (; walked_column_ < column_index; walked_column_++) {
+    walked_offset_ += GetStoredSize(walked_column_, walked_offset_);
+  }
+  return walked_offset_;
+}
+
+uint32_t RowView::GetStoredSize(uint32_t column_index, uint32_t offset) const {
+  if (IsNull(column_index)) {
+    return 0;
+  }
+  TypeId type = schema_->GetColumn(column_index)->GetType();
+  if (type == TypeId::kTypeChar) {
+    return sizeof(uint32_t) + MACH_READ_UINT32(data_ + offset);
+  }
+  return Type::GetTypeSize(type);
+}
+
+bool RowView::HasNullBefore(uint32_t column_index) const {
+  const char *null_bitmap = data_ + sizeof(uint32_t);
+  for (uint32_t i = 0; i < column_index / 8; i++) {
+    if (null_bitmap[i] != 0) {
+      return true;
+    }
+  }
+  return (null_bitmap[column_index / 8] & ((1 << (column_index % 8)) - 1)) != 0;
+}
+
+Field *RowView::NewField(uint32_t column_index) const {
+  TypeId type = schema_->GetColumn(column_index)->GetType();
+  if (IsNull(column_index)) {
+    return new Field(type);
+  }
+  const char *value = data_ + GetOffset(column_index);
+  switch (type) {
+    case TypeId::kTypeInt:
+      return new Field(type, MACH_READ_FROM(int32_t, value));
+    case TypeId::kTypeFloat:
+      return new Field(type, MACH_READ_FROM(float, value));
+    default:
+      return new Field(type, const_cast<char *>(value) + sizeof(uint32_t), MACH_READ_UINT32(value), true);
+  }
+}
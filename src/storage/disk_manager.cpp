@@ -1,107 +1,480 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <stdexcept>
 
+#include "common/lz_codec.h"
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+// an entry of the page map is the first slot of the page and its stored size in the low bits
+static constexpr int PAGE_MAP_SIZE_BITS = 16;
+static constexpr size_t PAGE_MAP_BLOCK_ENTRIES = PAGE_SIZE / sizeof(uint64_t);
+static_assert(PAGE_SIZE < (1 << PAGE_MAP_SIZE_BITS), "The size of a page must fit in a page map entry.");
+
+static uint32_t StoredSize(uint64_t entry) { return entry & ((1 << PAGE_MAP_SIZE_BITS) - 1); }
+
+static uint32_t SlotCount(uint64_t entry) { return (StoredSize(entry) + PAGE_SLOT_SIZE - 1) / PAGE_SLOT_SIZE; }
+
+DiskManager::DiskManager(const std::string &db_file, bool use_io_uring, bool direct_io, bool compress_pages)
+    : file_name_(db_file), use_io_uring_(use_io_uring), direct_io_(direct_io) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    std::filesystem::path p = db_file;
-    if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw std::exception();
-    }
+  // directory does not exist
+  std::filesystem::path p = db_file;
+  if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
+  db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | (direct_io_ ? O_DIRECT : 0), 0644);
+  if (db_fd_ < 0 && direct_io_ && errno == EINVAL) {
+    LOG(WARNING) << "Direct I/O is not supported for " << db_file << ", using the page cache";
+    direct_io_ = false;
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
   }
+  if (db_fd_ < 0) {
+    LOG(ERROR) << "Cannot open " << db_file << ": " << strerror(errno);
+    throw std::exception();
+  }
+  file_size_ = GetFileSize(db_fd_);
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  bool has_map = std::filesystem::exists(MapName(db_file));
+  if (has_map || (compress_pages && file_size_.load() == 0)) {
+    OpenPageMap(!has_map);
+  }
+  std::ifstream manifest(ManifestName(db_file));
+  for (std::string file_name; std::getline(manifest, file_name);) {
+    if (!file_name.empty()) {
+      OpenDataFile(file_name);
+    }
+  }
+}
+
+void DiskManager::RemoveFiles(const std::string &db_file) {
+  std::ifstream manifest(ManifestName(db_file));
+  for (std::string file_name; std::getline(manifest, file_name);) {
+    if (!file_name.empty()) {
+      remove(file_name.c_str());
+      remove(MapName(file_name).c_str());
+    }
+  }
+  remove(ManifestName(db_file).c_str());
+  remove(MapName(db_file).c_str());
+  remove(db_file.c_str());
+}
+
+std::string DiskManager::ManifestName(const std::string &db_file) {
+  // hidden, so that it is not listed as a database of its own
+  std::filesystem::path path = db_file;
+  return path.replace_filename("." + path.filename().string() + ".files").string();
+}
+
+std::string DiskManager::MapName(const std::string &db_file) {
+  std::filesystem::path path = db_file;
+  return path.replace_filename("." + path.filename().string() + ".map").string();
+}
+
+void DiskManager::OpenPageMap(bool create) {
+  std::string map_name = MapName(file_name_);
+  map_fd_ = open(map_name.c_str(), O_RDWR | (create ? O_CREAT : 0), 0644);
+  if (map_fd_ < 0) {
+    LOG(ERROR) << "Cannot open " << map_name << ": " << strerror(errno);
+    throw std::exception();
+  }
+  page_map_.resize(GetFileSize(map_fd_) / sizeof(uint64_t));
+  size_t size = page_map_.size() * sizeof(uint64_t);
+  if (ReadFully(map_fd_, reinterpret_cast<char *>(page_map_.data()), size, 0) != size) {
+    LOG(ERROR) << "Cannot read " << map_name;
+    throw std::exception();
+  }
+  map_dirty_.resize((page_map_.size() + PAGE_MAP_BLOCK_ENTRIES - 1) / PAGE_MAP_BLOCK_ENTRIES, false);
+  for (uint64_t entry : page_map_) {
+    uint64_t first_slot = entry >> PAGE_MAP_SIZE_BITS;
+    for (uint64_t slot = first_slot; slot < first_slot + SlotCount(entry); slot++) {
+      if (slot / BITMAP_SIZE >= slot_bitmaps_.size()) {
+        slot_bitmaps_.resize(slot / BITMAP_SIZE + 1);
+      }
+      auto &bitmap = slot_bitmaps_[slot / BITMAP_SIZE];
+      if (bitmap == nullptr) {
+        bitmap = std::make_unique<BitmapPage<PAGE_SIZE>>();
+      }
+      ASSERT(bitmap->AllocatePageAt(slot % BITMAP_SIZE), "Two pages share a slot in the page map.");
+    }
+  }
+}
+
+uint32_t DiskManager::AddDataFile(const std::string &file_name) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  uint32_t data_file = num_data_files_.load();
+  if (data_file == MAX_DATA_FILES) {
+    LOG(ERROR) << "A tablespace has at most " << MAX_DATA_FILES << " data files.";
+    return 0;
+  }
+  OpenDataFile(file_name);
+  std::ofstream manifest(ManifestName(file_name_), std::ios::app);
+  manifest << file_name << std::endl;
+  if (!manifest) {
+    LOG(ERROR) << "Cannot record " << file_name << " in the manifest of " << file_name_;
+  }
+  return data_file;
+}
+
+void DiskManager::OpenDataFile(const std::string &file_name) {
+  uint32_t data_file = num_data_files_.load();
+  ASSERT(data_file < MAX_DATA_FILES, "Too many data files in the manifest.");
+  data_files_[data_file] = std::make_unique<DiskManager>(file_name, use_io_uring_, direct_io_, IsCompressed());
+  num_data_files_.store(data_file + 1);
+}
+
+DiskManager *DiskManager::DataFile(page_id_t page_id) {
+  uint32_t data_file = DataFileOf(page_id);
+  if (data_file == 0) {
+    return nullptr;
+  }
+  ASSERT(data_file < num_data_files_.load(), "Page of a data file the tablespace does not have.");
+  return data_files_[data_file].get();
 }
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  WritePhysicalPage(META_PAGE_ID, meta_data_);
   if (!closed) {
-    db_io_.close();
+    // waits for the asynchronous I/Os in flight
+    io_uring_.reset();
+    Checkpoint();
+    for (uint32_t data_file = 1; data_file < num_data_files_.load(); data_file++) {
+      data_files_[data_file]->Close();
+    }
+    close(db_fd_);
+    if (map_fd_ >= 0) {
+      close(map_fd_);
+    }
     closed = true;
   }
 }
 
+IoUringEngine *DiskManager::AsyncEngine() {
+  if (use_io_uring_) {
+    std::call_once(io_uring_once_, [this] { io_uring_ = IoUringEngine::Create(IO_URING_QUEUE_DEPTH); });
+  }
+  return io_uring_.get();
+}
+
+bool DiskManager::IsAsync() {
+  return AsyncEngine() != nullptr;
+}
+
+void DiskManager::ReadPageAsync(page_id_t logical_page_id, char *page_data, IOCallback done) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (DiskManager *data_file = DataFile(logical_page_id)) {
+    return data_file->ReadPageAsync(LocalPageId(logical_page_id), page_data, std::move(done));
+  }
+  if (IsCompressed()) {
+    ReadCompressedPage(logical_page_id, page_data);
+    done();
+    return;
+  }
+  page_id_t physical_page_id = MapPageId(logical_page_id);
+  int64_t offset = static_cast<int64_t>(physical_page_id) * PAGE_SIZE;
+  IoUringEngine *engine = IsAligned(page_data) ? AsyncEngine() : nullptr;
+  if (engine == nullptr || offset >= file_size_.load()) {
+    ReadPhysicalPage(physical_page_id, page_data);
+    done();
+    return;
+  }
+  engine->Read(db_fd_, page_data, PAGE_SIZE, offset, [this, physical_page_id, page_data, done](int result) {
+    if (result < 0) {
+      // the kernel may not know the operation, the synchronous path reports real errors
+      ReadPhysicalPage(physical_page_id, page_data);
+    } else if (result < PAGE_SIZE) {
+      memset(page_data + result, 0, PAGE_SIZE - result);
+    }
+    done();
+  });
+}
+
+void DiskManager::WritePageAsync(page_id_t logical_page_id, const char *page_data, IOCallback done) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (DiskManager *data_file = DataFile(logical_page_id)) {
+    return data_file->WritePageAsync(LocalPageId(logical_page_id), page_data, std::move(done));
+  }
+  if (IsCompressed()) {
+    WriteCompressedPage(logical_page_id, page_data);
+    done();
+    return;
+  }
+  page_id_t physical_page_id = MapPageId(logical_page_id);
+  int64_t offset = static_cast<int64_t>(physical_page_id) * PAGE_SIZE;
+  IoUringEngine *engine = IsAligned(page_data) ? AsyncEngine() : nullptr;
+  if (engine == nullptr) {
+    WritePhysicalPage(physical_page_id, page_data);
+    done();
+    return;
+  }
+  engine->Write(db_fd_, page_data, PAGE_SIZE, offset, [this, physical_page_id, offset, page_data, done](int result) {
+    if (result == PAGE_SIZE) {
+      OnPageWritten(offset);
+    } else {
+      // finish a failed or short write on the synchronous path
+      WritePhysicalPage(physical_page_id, page_data);
+    }
+    done();
+  });
+}
+
+void DiskManager::Sync() {
+  for (uint32_t data_file = 1; data_file < num_data_files_.load(); data_file++) {
+    data_files_[data_file]->Sync();
+  }
+  uint64_t issued = write_count_.load();
+  std::lock_guard<std::mutex> guard(sync_latch_);
+  // the sync we waited for may have covered our writes already
+  if (synced_count_ >= issued) {
+    return;
+  }
+  uint64_t covered = write_count_.load();
+  if (fdatasync(db_fd_) != 0) {
+    LOG(ERROR) << "I/O error while syncing: " << strerror(errno);
+    return;
+  }
+  synced_count_ = covered;
+}
+
 void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (DiskManager *data_file = DataFile(logical_page_id)) {
+    return data_file->ReadPage(LocalPageId(logical_page_id), page_data);
+  }
+  if (IsCompressed()) {
+    return ReadCompressedPage(logical_page_id, page_data);
+  }
   ReadPhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (DiskManager *data_file = DataFile(logical_page_id)) {
+    return data_file->WritePage(LocalPageId(logical_page_id), page_data);
+  }
+  if (IsCompressed()) {
+    return WriteCompressedPage(logical_page_id, page_data);
+  }
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
+// compressed pages are read and written in here, aligned for direct I/O
+alignas(PAGE_SIZE) static thread_local char slot_buffer[PAGE_SIZE];
+
+void DiskManager::ReadCompressedPage(page_id_t logical_page_id, char *page_data) {
+  uint64_t entry = 0;
+  {
+    std::scoped_lock<std::mutex> lock(map_latch_);
+    if (static_cast<size_t>(logical_page_id) < page_map_.size()) {
+      entry = page_map_[logical_page_id];
+    }
+  }
+  uint32_t size = StoredSize(entry);
+  if (size == 0) {
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  size_t read_count =
+      ReadFully(db_fd_, slot_buffer, SlotCount(entry) * PAGE_SLOT_SIZE, SlotOffset(entry >> PAGE_MAP_SIZE_BITS));
+  if (read_count < size) {
+    LOG(ERROR) << "Page " << logical_page_id << " of " << file_name_ << " is cut short.";
+    memset(page_data, 0, PAGE_SIZE);
+  } else if (size == PAGE_SIZE) {
+    memcpy(page_data, slot_buffer, PAGE_SIZE);
+  } else if (!LZCodec::Decompress(slot_buffer, size, page_data, PAGE_SIZE)) {
+    LOG(ERROR) << "Page " << logical_page_id << " of " << file_name_ << " does not decompress.";
+    memset(page_data, 0, PAGE_SIZE);
+  }
+}
+
+void DiskManager::WriteCompressedPage(page_id_t logical_page_id, const char *page_data) {
+  // a page is worth compressing if it saves a slot at least
+  uint32_t size = LZCodec::Compress(page_data, PAGE_SIZE, slot_buffer, PAGE_SIZE - PAGE_SLOT_SIZE);
+  if (size == 0) {
+    memcpy(slot_buffer, page_data, PAGE_SIZE);
+    size = PAGE_SIZE;
+  }
+  uint32_t num_slots = (size + PAGE_SLOT_SIZE - 1) / PAGE_SLOT_SIZE;
+  memset(slot_buffer + size, 0, num_slots * PAGE_SLOT_SIZE - size);
+  uint64_t slot;
+  {
+    std::scoped_lock<std::mutex> lock(map_latch_);
+    slot = AllocateSlots(num_slots);
+  }
+  uint64_t entry = slot << PAGE_MAP_SIZE_BITS | size;
+  int64_t offset = SlotOffset(slot);
+  bool written = WriteFully(db_fd_, slot_buffer, num_slots * PAGE_SLOT_SIZE, offset);
+  std::scoped_lock<std::mutex> lock(map_latch_);
+  if (!written) {
+    FreeSlots(entry);
+    return;
+  }
+  OnPageWritten(offset, num_slots * PAGE_SLOT_SIZE);
+  if (static_cast<size_t>(logical_page_id) >= page_map_.size()) {
+    page_map_.resize(logical_page_id + 1);
+    map_dirty_.resize((page_map_.size() + PAGE_MAP_BLOCK_ENTRIES - 1) / PAGE_MAP_BLOCK_ENTRIES, false);
+  }
+  // the map on disk may still point to the old copy, its slots are freed by the next checkpoint
+  if (page_map_[logical_page_id] != 0) {
+    replaced_entries_.push_back(page_map_[logical_page_id]);
+  }
+  page_map_[logical_page_id] = entry;
+  map_dirty_[logical_page_id / PAGE_MAP_BLOCK_ENTRIES] = true;
+}
+
+uint64_t DiskManager::AllocateSlots(uint32_t num_slots) {
+  uint32_t slot_offset = 0;
+  for (size_t bitmap_id = 0;; bitmap_id++) {
+    if (bitmap_id == slot_bitmaps_.size()) {
+      slot_bitmaps_.push_back(std::make_unique<BitmapPage<PAGE_SIZE>>());
+    }
+    auto &bitmap = slot_bitmaps_[bitmap_id];
+    if (bitmap == nullptr) {
+      bitmap = std::make_unique<BitmapPage<PAGE_SIZE>>();
+    }
+    if (bitmap->AllocateRun(num_slots, slot_offset)) {
+      return bitmap_id * BITMAP_SIZE + slot_offset;
+    }
+  }
+}
+
+void DiskManager::FreeSlots(uint64_t entry) {
+  uint64_t first_slot = entry >> PAGE_MAP_SIZE_BITS;
+  for (uint64_t slot = first_slot; slot < first_slot + SlotCount(entry); slot++) {
+    slot_bitmaps_[slot / BITMAP_SIZE]->DeAllocatePage(slot % BITMAP_SIZE);
+  }
+}
+
+void DiskManager::CompactSlots() {
+  std::scoped_lock<std::mutex> lock(map_latch_);
+  std::vector<page_id_t> pages;
+  for (size_t page_id = 0; page_id < page_map_.size(); page_id++) {
+    if (page_map_[page_id] != 0) {
+      pages.push_back(page_id);
+    }
+  }
+  // the last pages of the file first, each one goes to the lowest run of free slots it fits in
+  std::sort(pages.begin(), pages.end(), [this](page_id_t a, page_id_t b) { return page_map_[a] > page_map_[b]; });
+  for (page_id_t page_id : pages) {
+    uint64_t entry = page_map_[page_id];
+    uint32_t num_slots = SlotCount(entry);
+    uint64_t slot = AllocateSlots(num_slots);
+    uint64_t moved = slot << PAGE_MAP_SIZE_BITS | StoredSize(entry);
+    if (slot > entry >> PAGE_MAP_SIZE_BITS) {
+      FreeSlots(moved);
+      continue;
+    }
+    size_t size = num_slots * PAGE_SLOT_SIZE;
+    if (ReadFully(db_fd_, slot_buffer, size, SlotOffset(entry >> PAGE_MAP_SIZE_BITS)) != size ||
+        !WriteFully(db_fd_, slot_buffer, size, SlotOffset(slot))) {
+      FreeSlots(moved);
+      return;
+    }
+    OnPageWritten(SlotOffset(slot), size);
+    replaced_entries_.push_back(entry);
+    page_map_[page_id] = moved;
+    map_dirty_[page_id / PAGE_MAP_BLOCK_ENTRIES] = true;
+  }
+}
+
+void DiskManager::CheckpointPageMap() {
+  std::scoped_lock<std::mutex> lock(map_latch_);
+  // the slots the map points to reach the disk before the map does
+  if (fdatasync(db_fd_) != 0) {
+    LOG(ERROR) << "I/O error while syncing: " << strerror(errno);
+    return;
+  }
+  for (size_t block = 0; block < map_dirty_.size(); block++) {
+    if (!map_dirty_[block]) {
+      continue;
+    }
+    size_t begin = block * PAGE_MAP_BLOCK_ENTRIES;
+    size_t count = std::min(PAGE_MAP_BLOCK_ENTRIES, page_map_.size() - begin);
+    if (!WriteFully(map_fd_, reinterpret_cast<const char *>(page_map_.data() + begin), count * sizeof(uint64_t),
+                    static_cast<int64_t>(begin * sizeof(uint64_t)))) {
+      return;
+    }
+    map_dirty_[block] = false;
+  }
+  if (fdatasync(map_fd_) != 0) {
+    LOG(ERROR) << "I/O error while syncing: " << strerror(errno);
+    return;
+  }
+  for (uint64_t entry : replaced_entries_) {
+    FreeSlots(entry);
+  }
+  replaced_entries_.clear();
+}
+
 /**
  * TODO: Student Implement
  */
-page_id_t DiskManager::AllocatePage() {
-  // read meta page
-  DiskFileMetaPage* meta_page = reinterpret_cast<DiskFileMetaPage*>(meta_data_);
-  if(meta_page->num_allocated_pages_ == MAX_VALID_PAGE_ID){
+page_id_t DiskManager::AllocatePage(uint32_t data_file) {
+  if (data_file != 0) {
+    ASSERT(data_file < num_data_files_.load(), "No such data file.");
+    page_id_t page_id = data_files_[data_file]->AllocatePage();
+    return page_id == INVALID_PAGE_ID ? INVALID_PAGE_ID : MakePageId(data_file, page_id);
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (meta_page->num_allocated_pages_ == MAX_VALID_PAGE_ID) {
     return INVALID_PAGE_ID;
   }
-  // find the first free page
-  // if there is free page in existed page
-  for(uint32_t i = 0;i < meta_page->num_extents_;i++){
-    if(meta_page->GetExtentUsedPage(i) < BITMAP_SIZE){
-      BitmapPage<PAGE_SIZE>* bitmap_page = new BitmapPage<PAGE_SIZE>();
-      ReadPhysicalPage(1 + i * (BITMAP_SIZE + 1),reinterpret_cast<char*>(bitmap_page));
-      uint32_t page_offset;
-      bool res = bitmap_page->AllocatePage(page_offset);
-      ASSERT(res,"Allocate page failed");
-      if(res){
-        meta_page->num_allocated_pages_++;
-        meta_page->extent_used_page_[i]++;
-        WritePhysicalPage(1 + i * (BITMAP_SIZE + 1),reinterpret_cast<char*>(bitmap_page));
-        return i * BITMAP_SIZE + page_offset;
-      }
-    }
+  // the extents below the hint are full, take the first one after it with room or append a new one
+  uint32_t extent_id = next_free_extent_;
+  while (extent_id < meta_page->num_extents_ && meta_page->extent_used_page_[extent_id] >= BITMAP_SIZE) {
+    extent_id++;
   }
-  // create a new extent
-  BitmapPage<PAGE_SIZE>* bitmap_page = new BitmapPage<PAGE_SIZE>();
-  uint32_t page_offset = 0;
-  bitmap_page->AllocatePage(page_offset);
-  WritePhysicalPage(1 + meta_page->num_extents_ * (BITMAP_SIZE + 1),reinterpret_cast<char*>(bitmap_page));
+  next_free_extent_ = extent_id;
+  BitmapPage<PAGE_SIZE> *bitmap_page = GetBitmap(extent_id);
+  if (extent_id == meta_page->num_extents_) {
+    meta_page->extent_used_page_[extent_id] = 0;
+    meta_page->num_extents_++;
+  }
+  uint32_t page_offset;
+  bool res = bitmap_page->AllocatePage(page_offset);
+  ASSERT(res, "Allocate page failed");
+  if (!res) {
+    return INVALID_PAGE_ID;
+  }
+  bitmap_dirty_[extent_id] = true;
   meta_page->num_allocated_pages_++;
-  meta_page->extent_used_page_[meta_page->num_extents_]++;
-  meta_page->num_extents_++;
-  return (meta_page->num_extents_ - 1) * BITMAP_SIZE + page_offset;
+  meta_page->extent_used_page_[extent_id]++;
+  return extent_id * BITMAP_SIZE + page_offset;
 }
+
 /**
  * TODO: Student Implement
  */
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
+  if (DiskManager *data_file = DataFile(logical_page_id)) {
+    return data_file->DeAllocatePage(LocalPageId(logical_page_id));
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
   uint32_t extent_id = logical_page_id / BITMAP_SIZE;
-  page_id_t bitmap_page_id = 1 + extent_id * (BITMAP_SIZE + 1);
-
-  DiskFileMetaPage* meta_page = reinterpret_cast<DiskFileMetaPage*>(meta_data_);
-  BitmapPage<PAGE_SIZE>* bitmap_page = new BitmapPage<PAGE_SIZE>();
-
-  ReadPhysicalPage(bitmap_page_id,reinterpret_cast<char*>(bitmap_page));
-  uint32_t page_offset = logical_page_id % BITMAP_SIZE;
-  bool res = bitmap_page->DeAllocatePage(page_offset);
-  if(res){
-    meta_page->num_allocated_pages_--;
-    meta_page->extent_used_page_[extent_id]--;
-    WritePhysicalPage(bitmap_page_id,reinterpret_cast<char*>(bitmap_page));
-  }else{
+  if (extent_id >= meta_page->num_extents_ || !GetBitmap(extent_id)->DeAllocatePage(logical_page_id % BITMAP_SIZE)) {
     LOG(ERROR) << "Deallocate page failed." << logical_page_id;
+    return;
+  }
+  bitmap_dirty_[extent_id] = true;
+  meta_page->num_allocated_pages_--;
+  meta_page->extent_used_page_[extent_id]--;
+  next_free_extent_ = std::min(next_free_extent_, extent_id);
+  if (IsCompressed()) {
+    std::scoped_lock<std::mutex> map_lock(map_latch_);
+    if (static_cast<size_t>(logical_page_id) < page_map_.size() && page_map_[logical_page_id] != 0) {
+      replaced_entries_.push_back(page_map_[logical_page_id]);
+      page_map_[logical_page_id] = 0;
+      map_dirty_[logical_page_id / PAGE_MAP_BLOCK_ENTRIES] = true;
+    }
   }
 }
 
@@ -110,19 +483,139 @@ void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
  * 访问对应的bitmappage，然后调用bitmap的函数
  */
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-  BitmapPage<PAGE_SIZE>* bitmap_page = new BitmapPage<PAGE_SIZE>();
+  if (DiskManager *data_file = DataFile(logical_page_id)) {
+    return data_file->IsPageFree(LocalPageId(logical_page_id));
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   uint32_t extent_id = logical_page_id / BITMAP_SIZE;
-  uint32_t page_offset = logical_page_id % BITMAP_SIZE;
-  page_id_t bitmap_page_id = 1 + extent_id * (BITMAP_SIZE + 1);
   // if the extent_id is larger than the number of extents, then the page is free
-  if (extent_id >= reinterpret_cast<DiskFileMetaPage*>(meta_data_)->num_extents_)
-  {
+  if (extent_id >= reinterpret_cast<DiskFileMetaPage *>(meta_data_)->num_extents_) {
     return true;
   }
-  ReadPhysicalPage(bitmap_page_id,reinterpret_cast<char*>(bitmap_page));
-  bool is_free = bitmap_page->IsPageFree(page_offset);
-  delete bitmap_page;
-  return is_free;
+  return GetBitmap(extent_id)->IsPageFree(logical_page_id % BITMAP_SIZE);
+}
+
+page_id_t DiskManager::AllocateExtent(uint32_t num_pages, uint32_t data_file) {
+  if (data_file != 0) {
+    ASSERT(data_file < num_data_files_.load(), "No such data file.");
+    page_id_t page_id = data_files_[data_file]->AllocateExtent(num_pages);
+    return page_id == INVALID_PAGE_ID ? INVALID_PAGE_ID : MakePageId(data_file, page_id);
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (num_pages == 0 || num_pages > BITMAP_SIZE || meta_page->num_allocated_pages_ + num_pages > MAX_VALID_PAGE_ID) {
+    return INVALID_PAGE_ID;
+  }
+  // first fit over the extents with enough free pages, a run never spans two extents
+  uint32_t extent_id = next_free_extent_;
+  uint32_t page_offset = 0;
+  for (; extent_id < meta_page->num_extents_; extent_id++) {
+    if (BITMAP_SIZE - meta_page->extent_used_page_[extent_id] >= num_pages &&
+        GetBitmap(extent_id)->AllocateRun(num_pages, page_offset)) {
+      break;
+    }
+  }
+  if (extent_id == meta_page->num_extents_) {
+    bool res = GetBitmap(extent_id)->AllocateRun(num_pages, page_offset);
+    ASSERT(res, "Allocate extent failed");
+    meta_page->extent_used_page_[extent_id] = 0;
+    meta_page->num_extents_++;
+  }
+  bitmap_dirty_[extent_id] = true;
+  meta_page->num_allocated_pages_ += num_pages;
+  meta_page->extent_used_page_[extent_id] += num_pages;
+  return extent_id * BITMAP_SIZE + page_offset;
+}
+
+BitmapPage<PAGE_SIZE> *DiskManager::GetBitmap(uint32_t extent_id) {
+  if (extent_id >= bitmaps_.size()) {
+    bitmaps_.resize(extent_id + 1);
+    bitmap_dirty_.resize(extent_id + 1, false);
+  }
+  if (bitmaps_[extent_id] == nullptr) {
+    bitmaps_[extent_id] = std::make_unique<BitmapPage<PAGE_SIZE>>();
+    // a new extent starts with an empty bitmap, whatever the file holds at its place
+    if (extent_id < reinterpret_cast<DiskFileMetaPage *>(meta_data_)->num_extents_) {
+      ReadPhysicalPage(BitmapPageId(extent_id), reinterpret_cast<char *>(bitmaps_[extent_id].get()));
+    } else {
+      bitmap_dirty_[extent_id] = true;
+    }
+  }
+  return bitmaps_[extent_id].get();
+}
+
+uint64_t DiskManager::Truncate() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  uint64_t released = 0;
+  for (uint32_t data_file = 1; data_file < num_data_files_.load(); data_file++) {
+    released += data_files_[data_file]->Truncate();
+  }
+  // empty extents at the end go away with their bitmaps, the file ends after the last allocated page of the others
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  while (meta_page->num_extents_ > 0 && meta_page->extent_used_page_[meta_page->num_extents_ - 1] == 0) {
+    meta_page->num_extents_--;
+  }
+  uint32_t num_extents = meta_page->num_extents_;
+  if (bitmaps_.size() > num_extents) {
+    bitmaps_.resize(num_extents);
+    bitmap_dirty_.resize(num_extents);
+  }
+  next_free_extent_ = std::min(next_free_extent_, num_extents);
+  int64_t num_pages = META_PAGE_ID + 1;
+  if (num_extents > 0) {
+    num_pages = BitmapPageId(num_extents - 1) + 1 + (IsCompressed() ? 0 : GetBitmap(num_extents - 1)->GetUsedEnd());
+  }
+  if (IsCompressed()) {
+    // the pages are in the slots, the file ends after the last slot in use once they are packed at the front
+    CheckpointPageMap();
+    CompactSlots();
+    CheckpointPageMap();
+    std::scoped_lock<std::mutex> map_lock(map_latch_);
+    while (!slot_bitmaps_.empty() && (slot_bitmaps_.back() == nullptr || slot_bitmaps_.back()->GetUsedEnd() == 0)) {
+      slot_bitmaps_.pop_back();
+    }
+    if (!slot_bitmaps_.empty()) {
+      uint64_t last_slot = (slot_bitmaps_.size() - 1) * BITMAP_SIZE + slot_bitmaps_.back()->GetUsedEnd() - 1;
+      num_pages = std::max<int64_t>(num_pages, MapPageId(last_slot / SLOTS_PER_PAGE) + 1);
+    }
+  }
+  int64_t size = num_pages * PAGE_SIZE;
+  if (size < file_size_.load()) {
+    if (ftruncate(db_fd_, size) != 0) {
+      LOG(ERROR) << "Cannot truncate " << file_name_ << ": " << strerror(errno);
+    } else {
+      released += (file_size_.load() - size) / PAGE_SIZE;
+      file_size_ = size;
+    }
+  }
+  Checkpoint();
+  return released;
+}
+
+uint64_t DiskManager::GetFilePages() const {
+  uint64_t pages = file_size_.load() / PAGE_SIZE;
+  for (uint32_t data_file = 1; data_file < num_data_files_.load(); data_file++) {
+    pages += data_files_[data_file]->GetFilePages();
+  }
+  return pages;
+}
+
+void DiskManager::Checkpoint() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  for (uint32_t data_file = 1; data_file < num_data_files_.load(); data_file++) {
+    data_files_[data_file]->Checkpoint();
+  }
+  if (IsCompressed()) {
+    CheckpointPageMap();
+  }
+  for (uint32_t extent_id = 0; extent_id < bitmaps_.size(); extent_id++) {
+    if (bitmap_dirty_[extent_id]) {
+      WritePhysicalPage(BitmapPageId(extent_id), reinterpret_cast<const char *>(bitmaps_[extent_id].get()));
+      bitmap_dirty_[extent_id] = false;
+    }
+  }
+  WritePhysicalPage(META_PAGE_ID, meta_data_);
+  Sync();
 }
 
 /**
@@ -132,45 +625,95 @@ page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
   return 1 + logical_page_id / BITMAP_SIZE * (BITMAP_SIZE + 1) + 1 + logical_page_id % BITMAP_SIZE;
 }
 
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(int fd) {
   struct stat stat_buf;
-  int rc = stat(file_name.c_str(), &stat_buf);
+  int rc = fstat(fd, &stat_buf);
   return rc == 0 ? stat_buf.st_size : -1;
 }
 
+bool DiskManager::IsAligned(const char *page_data) const {
+  return !direct_io_ || reinterpret_cast<uintptr_t>(page_data) % PAGE_SIZE == 0;
+}
+
+// direct I/O of buffers that are not aligned goes through here
+alignas(PAGE_SIZE) static thread_local char bounce_buffer[PAGE_SIZE];
+
 void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+  if (!IsAligned(page_data)) {
+    ReadPhysicalPage(physical_page_id, bounce_buffer);
+    memcpy(page_data, bounce_buffer, PAGE_SIZE);
+    return;
+  }
+  int64_t offset = static_cast<int64_t>(physical_page_id) * PAGE_SIZE;
   // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
+  if (offset >= file_size_.load()) {
 #ifdef ENABLE_BPM_DEBUG
     LOG(INFO) << "Read less than a page" << std::endl;
 #endif
     memset(page_data, 0, PAGE_SIZE);
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
+    return;
+  }
+  size_t read_count = ReadFully(db_fd_, page_data, PAGE_SIZE, offset);
+  // if file ends before reading PAGE_SIZE
+  if (read_count < PAGE_SIZE) {
 #ifdef ENABLE_BPM_DEBUG
-      LOG(INFO) << "Read less than a page" << std::endl;
+    LOG(INFO) << "Read less than a page" << std::endl;
 #endif
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
-    }
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
   }
 }
 
 void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG(ERROR) << "I/O error while writing";
-    return;
+  if (!IsAligned(page_data)) {
+    memcpy(bounce_buffer, page_data, PAGE_SIZE);
+    page_data = bounce_buffer;
+  }
+  int64_t offset = static_cast<int64_t>(physical_page_id) * PAGE_SIZE;
+  if (WriteFully(db_fd_, page_data, PAGE_SIZE, offset)) {
+    OnPageWritten(offset);
+  }
+}
+
+size_t DiskManager::ReadFully(int fd, char *data, size_t size, int64_t offset) {
+  size_t read_count = 0;
+  while (read_count < size) {
+    ssize_t rc = pread(fd, data + read_count, size - read_count, offset + read_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc < 0) {
+      LOG(ERROR) << "I/O error while reading: " << strerror(errno);
+    }
+    if (rc <= 0) {
+      break;
+    }
+    read_count += rc;
+  }
+  return read_count;
+}
+
+bool DiskManager::WriteFully(int fd, const char *data, size_t size, int64_t offset) {
+  size_t write_count = 0;
+  while (write_count < size) {
+    ssize_t rc = pwrite(fd, data + write_count, size - write_count, offset + write_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    // check for I/O error
+    if (rc < 0) {
+      LOG(ERROR) << "I/O error while writing: " << strerror(errno);
+      return false;
+    }
+    write_count += rc;
+  }
+  return true;
+}
+
+void DiskManager::OnPageWritten(int64_t offset, int64_t size) {
+  write_count_++;
+  // grow the cached size, other writers may be extending the file at the same time
+  int64_t end = offset + size;
+  int64_t file_size = file_size_.load();
+  while (file_size < end && !file_size_.compare_exchange_weak(file_size, end)) {
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
-}
\ No newline at end of file
+}
@@ -0,0 +1,31 @@
+#include "storage/extent_allocator.h"
+
+page_id_t ExtentAllocator::AllocatePage(DiskManager *disk_manager) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (next_ == end_) {
+    page_id_t first = disk_manager->AllocateExtent(run_size_, data_file_);
+    if (first == INVALID_PAGE_ID) {
+      // the file has no room for a whole run, single pages may still fit
+      return disk_manager->AllocatePage(data_file_);
+    }
+    next_ = first;
+    end_ = first + static_cast<page_id_t>(run_size_);
+  }
+  return next_++;
+}
+
+void ExtentAllocator::DeAllocatePage(DiskManager *disk_manager, page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (next_ != INVALID_PAGE_ID && page_id == next_ - 1) {
+    next_--;
+    return;
+  }
+  disk_manager->DeAllocatePage(page_id);
+}
+
+void ExtentAllocator::Release(DiskManager *disk_manager) {
+  std::lock_guard<std::mutex> guard(latch_);
+  for (; next_ != end_; next_++) {
+    disk_manager->DeAllocatePage(next_);
+  }
+}
@@ -0,0 +1,115 @@
+#include "storage/free_space_map.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+
+static constexpr uint32_t FSM_BUCKET_BYTES = PAGE_SIZE / FSM_BUCKETS;
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, uint32_t data_file)
+    : buffer_pool_manager_(buffer_pool_manager), first_page_id_(first_page_id), last_map_page_id_(first_page_id) {
+  if (first_page_id_ == INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager_->NewPage(first_page_id_, data_file);
+    ASSERT(page != nullptr, "Cannot allocate the free-space map.");
+    page->SetPageType(PageType::kTable);
+    reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+    buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    last_map_page_id_ = first_page_id_;
+    return;
+  }
+  // a page of the map covers MAX_ENTRY_COUNT pages of the table, reading all of it is cheap
+  for (page_id_t map_page_id = first_page_id_; map_page_id != INVALID_PAGE_ID;) {
+    FreeSpaceMapPage *map_page = FetchMapPage(map_page_id);
+    for (uint32_t i = 0; i < map_page->GetEntryCount(); i++) {
+      uint8_t bucket = map_page->GetBucket(i);
+      entries_[map_page->GetPageId(i)] = {map_page_id, i, bucket};
+      buckets_[bucket].insert(map_page->GetPageId(i));
+      last_page_id_ = map_page->GetPageId(i);
+    }
+    last_map_page_id_ = map_page_id;
+    page_id_t next_page_id = map_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(map_page_id, false);
+    map_page_id = next_page_id;
+  }
+}
+
+uint8_t FreeSpaceMap::BucketOf(uint32_t free_space) {
+  return static_cast<uint8_t>(std::min<uint32_t>(free_space / FSM_BUCKET_BYTES, FSM_BUCKETS - 1));
+}
+
+FreeSpaceMapPage *FreeSpaceMap::FetchMapPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  ASSERT(page != nullptr, "Cannot fetch a page of the free-space map.");
+  page->SetPageType(PageType::kTable);
+  return reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+}
+
+page_id_t FreeSpaceMap::FindPage(uint32_t size) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // every page of the class rounded up has room, the lower classes may not
+  for (uint32_t bucket = (size + FSM_BUCKET_BYTES - 1) / FSM_BUCKET_BYTES; bucket < FSM_BUCKETS; bucket++) {
+    if (!buckets_[bucket].empty()) {
+      return *buckets_[bucket].begin();
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+void FreeSpaceMap::AddPage(page_id_t page_id, uint32_t free_space) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  uint8_t bucket = BucketOf(free_space);
+  FreeSpaceMapPage *map_page = FetchMapPage(last_map_page_id_);
+  if (!map_page->Append(page_id, bucket)) {
+    page_id_t new_page_id;
+    Page *page = buffer_pool_manager_->NewPage(new_page_id, DiskManager::DataFileOf(first_page_id_));
+    if (page == nullptr) {
+      // the page is still in the chain of the table, it is only never offered; it ends the chain all the same, the
+      // next page must be linked after it or it and its rows are cut out of the table
+      LOG(WARNING) << "Cannot grow the free-space map, page " << page_id << " is left out." << std::endl;
+      last_page_id_ = page_id;
+      buffer_pool_manager_->UnpinPage(last_map_page_id_, false);
+      return;
+    }
+    page->SetPageType(PageType::kTable);
+    map_page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(last_map_page_id_, true);
+    last_map_page_id_ = new_page_id;
+    map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+    map_page->Init();
+    map_page->Append(page_id, bucket);
+  }
+  entries_[page_id] = {last_map_page_id_, map_page->GetEntryCount() - 1, bucket};
+  buckets_[bucket].insert(page_id);
+  last_page_id_ = page_id;
+  buffer_pool_manager_->UnpinPage(last_map_page_id_, true);
+}
+
+void FreeSpaceMap::UpdatePage(page_id_t page_id, uint32_t free_space) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = entries_.find(page_id);
+  uint8_t bucket = BucketOf(free_space);
+  if (it == entries_.end() || it->second.bucket_ == bucket) {
+    return;
+  }
+  Entry &entry = it->second;
+  buckets_[entry.bucket_].erase(page_id);
+  buckets_[bucket].insert(page_id);
+  entry.bucket_ = bucket;
+  FetchMapPage(entry.map_page_id_)->SetBucket(entry.index_, bucket);
+  buffer_pool_manager_->UnpinPage(entry.map_page_id_, true);
+}
+
+void FreeSpaceMap::Destroy() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (page_id_t map_page_id = first_page_id_; map_page_id != INVALID_PAGE_ID;) {
+    page_id_t next_page_id = FetchMapPage(map_page_id)->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(map_page_id, false);
+    buffer_pool_manager_->DeletePage(map_page_id);
+    map_page_id = next_page_id;
+  }
+  first_page_id_ = last_map_page_id_ = last_page_id_ = INVALID_PAGE_ID;
+  entries_.clear();
+  for (auto &pages : buckets_) {
+    pages.clear();
+  }
+}
@@ -0,0 +1,179 @@
+#include "storage/io_uring_engine.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "glog/logging.h"
+
+static int IoUringSetup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+std::unique_ptr<IoUringEngine> IoUringEngine::Create(unsigned queue_depth) {
+  std::unique_ptr<IoUringEngine> engine(new IoUringEngine());
+  if (!engine->Setup(queue_depth)) {
+    return nullptr;
+  }
+  engine->completion_thread_ = std::thread(&IoUringEngine::CompletionLoop, engine.get());
+  return engine;
+}
+
+bool IoUringEngine::Setup(unsigned queue_depth) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = IoUringSetup(queue_depth, &params);
+  if (ring_fd_ < 0) {
+    LOG(WARNING) << "io_uring is not available: " << strerror(errno);
+    return false;
+  }
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  // both queues share one mapping on kernels that offer it
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                  IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    return false;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return false;
+  }
+  sqes_ = reinterpret_cast<io_uring_sqe *>(sqes);
+
+  auto *sq = reinterpret_cast<char *>(sq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto *cq = reinterpret_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+  // never more I/Os in flight than the completion queue holds
+  unsigned slots = std::min(queue_depth, params.cq_entries - 1);
+  callbacks_.resize(slots);
+  for (unsigned i = 0; i < slots; i++) {
+    free_slots_.push_back(slots - 1 - i);
+  }
+  return true;
+}
+
+IoUringEngine::~IoUringEngine() {
+  if (completion_thread_.joinable()) {
+    std::unique_lock<std::mutex> lock(latch_);
+    slot_cv_.wait(lock, [this] { return free_slots_.size() == callbacks_.size(); });
+    lock.unlock();
+    // a no-op without callback tells the completion thread to stop
+    Submit(IORING_OP_NOP, -1, nullptr, 0, 0, nullptr);
+    completion_thread_.join();
+  }
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+void IoUringEngine::Read(int fd, char *data, uint32_t size, int64_t offset, Callback done) {
+  Submit(IORING_OP_READ, fd, data, size, offset, std::move(done));
+}
+
+void IoUringEngine::Write(int fd, const char *data, uint32_t size, int64_t offset, Callback done) {
+  Submit(IORING_OP_WRITE, fd, data, size, offset, std::move(done));
+}
+
+void IoUringEngine::Submit(uint8_t opcode, int fd, const void *data, uint32_t size, int64_t offset, Callback done) {
+  std::unique_lock<std::mutex> lock(latch_);
+  uint64_t user_data = 0;
+  if (done != nullptr) {
+    slot_cv_.wait(lock, [this] { return !free_slots_.empty(); });
+    unsigned slot = free_slots_.back();
+    free_slots_.pop_back();
+    callbacks_[slot] = std::move(done);
+    user_data = slot + 1;
+  }
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(data);
+  sqe->len = size;
+  sqe->off = static_cast<uint64_t>(offset);
+  sqe->user_data = user_data;
+  sq_array_[index] = index;
+  // the kernel must see the entry before the new tail
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  int rc;
+  while ((rc = IoUringEnter(ring_fd_, 1, 0, 0)) < 0 && (errno == EINTR || errno == EAGAIN)) {
+  }
+  if (rc < 0) {
+    LOG(ERROR) << "io_uring submission failed: " << strerror(errno);
+  }
+}
+
+void IoUringEngine::CompletionLoop() {
+  while (true) {
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      if (IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+        LOG(ERROR) << "io_uring wait failed: " << strerror(errno);
+      }
+      continue;
+    }
+    io_uring_cqe cqe = cqes_[head & *cq_mask_];
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    if (cqe.user_data == 0) {
+      return;
+    }
+    unsigned slot = static_cast<unsigned>(cqe.user_data - 1);
+    Callback done;
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      done = std::move(callbacks_[slot]);
+      callbacks_[slot] = nullptr;
+    }
+    done(cqe.res);
+    {
+      // the slot is freed after the callback, so waiting for all slots waits for the callbacks too
+      std::lock_guard<std::mutex> guard(latch_);
+      free_slots_.push_back(slot);
+    }
+    slot_cv_.notify_all();
+  }
+}
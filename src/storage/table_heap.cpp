@@ -4,33 +4,113 @@
  * TODO: Student Implement
  */
 bool TableHeap::InsertTuple(Row &row, Txn *txn) {
-  if(row.GetSerializedSize(schema_) >= PAGE_SIZE) return false;
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(GetFirstPageId()));
+  uint32_t serialized_size = row.GetSerializedSize(schema_);
+  if (serialized_size > TablePage::SIZE_MAX_ROW) {
+    return false;
+  }
+  uint32_t space = serialized_size + TablePage::SIZE_TUPLE;
+  // a page the map offers has room, unless the map is behind it: then the page is filed again and the next one tried
+  for (page_id_t page_id = fsm_.FindPage(space); page_id != INVALID_PAGE_ID; page_id = fsm_.FindPage(space)) {
+    auto page = FetchTablePage(page_id);
+    if (page == nullptr) {
+      return false;
+    }
+    bool inserted = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+    fsm_.UpdatePage(page_id, page->GetFreeSpaceRemaining());
+    buffer_pool_manager_->UnpinPage(page_id, inserted);
+    if (inserted) {
+      return true;
+    }
+  }
+  // no page has room, the table grows by a page at the end of its chain
+  page_id_t last_page_id = fsm_.GetLastPageId();
+  auto last_page = FetchTablePage(last_page_id);
+  if (last_page == nullptr) {
+    return false;
+  }
+  page_id_t page_id;
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(page_id, &extents_));
   if (page == nullptr) {
+    buffer_pool_manager_->UnpinPage(last_page_id, false);
     return false;
   }
-  while(!page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)){
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-    page_id_t next_page_id = page->GetNextPageId();
-    if(next_page_id == INVALID_PAGE_ID){
-      auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(next_page_id));
-      page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, page->GetTablePageId(), log_manager_, txn);
-      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
-      page = new_page;
-    }else{
-      auto next_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-      page = next_page;
+  page->Init(page_id, last_page_id, log_manager_, txn);
+  last_page->SetNextPageId(page_id);
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  bool inserted = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+  fsm_.AddPage(page_id, page->GetFreeSpaceRemaining());
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  return inserted;
+}
+
+size_t TableHeap::BulkInsert(std::vector<Row> &rows, Txn *txn) {
+  for (auto &row : rows) {
+    if (row.GetSerializedSize(schema_) > TablePage::SIZE_MAX_ROW) {
+      return 0;
     }
   }
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  return true;
+  if (rows.empty()) {
+    return 0;
+  }
+  page_id_t page_id = fsm_.GetLastPageId();
+  auto page = FetchTablePage(page_id);
+  if (page == nullptr) {
+    return 0;
+  }
+  bool is_dirty = false;
+  size_t inserted = 0;
+  for (auto &row : rows) {
+    if (page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
+      is_dirty = true;
+      inserted++;
+      continue;
+    }
+    // the page is full, the map learns how full once instead of after every row
+    page_id_t next_page_id;
+    auto next_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(next_page_id, &extents_));
+    if (next_page == nullptr) {
+      break;
+    }
+    next_page->Init(next_page_id, page_id, log_manager_, txn);
+    page->SetNextPageId(next_page_id);
+    fsm_.UpdatePage(page_id, page->GetFreeSpaceRemaining());
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    fsm_.AddPage(next_page_id, next_page->GetFreeSpaceRemaining());
+    page_id = next_page_id;
+    page = next_page;
+    is_dirty = true;
+    // an empty page takes any row that is not too large
+    if (!page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
+      break;
+    }
+    inserted++;
+  }
+  fsm_.UpdatePage(page_id, page->GetFreeSpaceRemaining());
+  buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+  return inserted;
+}
+
+void TableHeap::BuildFreeSpaceMap() {
+  page_id_t page_id = first_page_id_;
+  if (fsm_.GetLastPageId() != INVALID_PAGE_ID) {
+    auto last_page = FetchTablePage(fsm_.GetLastPageId());
+    ASSERT(last_page != nullptr, "Cannot fetch a page of the table.");
+    page_id = last_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(fsm_.GetLastPageId(), false);
+  }
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = FetchTablePage(page_id);
+    ASSERT(page != nullptr, "Cannot fetch a page of the table.");
+    fsm_.AddPage(page_id, page->GetFreeSpaceRemaining());
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
 }
 
 bool TableHeap::MarkDelete(const RowId &rid, Txn *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = FetchTablePage(rid.GetPageId());
   // If the page could not be found, then abort the recovery.
   if (page == nullptr) {
     return false;
@@ -48,7 +128,7 @@ bool TableHeap::MarkDelete(const RowId &rid, Txn *txn) {
  */
 bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Txn *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = FetchTablePage(rid.GetPageId());
   if (page == nullptr) {
     return false;
   }
@@ -72,6 +152,7 @@ bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Txn *txn) {
   }
   else{
     row.SetRowId(rid);
+    fsm_.UpdatePage(rid.GetPageId(), page->GetFreeSpaceRemaining());
     buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
     return true;
   }
@@ -81,16 +162,18 @@ bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Txn *txn) {
  */
 void TableHeap::ApplyDelete(const RowId &rid, Txn *txn) {
   // Step1: Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = FetchTablePage(rid.GetPageId());
   ASSERT(page != nullptr, "The page could not be found.");
   // Step2: Delete the tuple from the page.
   page->ApplyDelete(rid, txn, log_manager_);
+  // the space of the row is free from now on, a marked row still holds it
+  fsm_.UpdatePage(rid.GetPageId(), page->GetFreeSpaceRemaining());
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
 void TableHeap::RollbackDelete(const RowId &rid, Txn *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = FetchTablePage(rid.GetPageId());
   assert(page != nullptr);
   // Rollback to delete.
   page->WLatch();
@@ -104,7 +187,7 @@ void TableHeap::RollbackDelete(const RowId &rid, Txn *txn) {
  */
 bool TableHeap::GetTuple(Row *row, Txn *txn) {
   page_id_t page_id = row->GetRowId().GetPageId();
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  auto page = FetchTablePage(page_id);
   if (page == nullptr) {
     return false;
   }
@@ -115,33 +198,22 @@ bool TableHeap::GetTuple(Row *row, Txn *txn) {
 
 void TableHeap::DeleteTable(page_id_t page_id) {
   if (page_id != INVALID_PAGE_ID) {
-    auto temp_table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));  // 删除table_heap
+    auto temp_table_page = FetchTablePage(page_id);  // 删除table_heap
     if (temp_table_page->GetNextPageId() != INVALID_PAGE_ID)
       DeleteTable(temp_table_page->GetNextPageId());
     buffer_pool_manager_->UnpinPage(page_id, false);
     buffer_pool_manager_->DeletePage(page_id);
   } else {
     DeleteTable(first_page_id_);
+    fsm_.Destroy();
   }
 }
 
 /**
  * TODO: Student Implement
  */
-TableIterator TableHeap::Begin(Txn *txn) {
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(GetFirstPageId()));
-  if (page == nullptr) {
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-    return TableIterator(this, RowId(), nullptr);
-  }
-  RowId rid;
-  if(page->GetFirstTupleRid(&rid)){
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-    return TableIterator(this, rid, txn);
-  }else{
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
-    return TableIterator(this, RowId(), nullptr);
-  }
+TableIterator TableHeap::Begin(Txn *txn, BufferAccessStrategy *strategy) {
+  return TableIterator(this, RowId(first_page_id_, 0), txn, strategy);
 }
 
 /**
@@ -3,27 +3,55 @@
 #include "common/macros.h"
 #include "storage/table_heap.h"
 
+static page_id_t NextTablePageId(Page *page) {
+  return reinterpret_cast<TablePage *>(page)->GetNextPageId();
+}
+
 /**
  * TODO: Student Implement
  */
-TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Txn *txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Txn *txn, BufferAccessStrategy *strategy)
+    : read_ahead_(table_heap == nullptr ? nullptr : table_heap->buffer_pool_manager_, NextTablePageId,
+                  table_heap == nullptr ? 0 : table_heap->prefetch_distance_, strategy) {
   table_heap_ = table_heap;
   rid_ = rid;
   txn_ = txn;
+  strategy_ = strategy;
+  if (table_heap_ == nullptr || rid_.GetPageId() == INVALID_PAGE_ID) {
+    Reset();
+    return;
+  }
+  page_ = table_heap_->FetchTablePage(rid_.GetPageId(), strategy_);
+  if (page_ == nullptr) {
+    Reset();
+    return;
+  }
+  read_ahead_.Advance(rid_.GetPageId());
+  FindRow(page_->GetTupleData(rid_.GetSlotNum()) != nullptr || page_->GetNextTupleRid(rid_, &rid_));
 }
 
-TableIterator::TableIterator(const TableIterator &other) {
+TableIterator::TableIterator(const TableIterator &other) : read_ahead_(other.read_ahead_) {
   table_heap_ = other.table_heap_;
   rid_ = other.rid_;
   txn_ = other.txn_;
+  strategy_ = other.strategy_;
+  if (other.page_ != nullptr) {
+    page_ = table_heap_->FetchTablePage(rid_.GetPageId(), strategy_);
+  }
 }
 
-TableIterator::~TableIterator() {
-  table_heap_ = nullptr;
-  rid_ = RowId();
-  txn_ = nullptr;
+TableIterator::TableIterator(TableIterator &&other) noexcept : read_ahead_(other.read_ahead_) {
+  table_heap_ = other.table_heap_;
+  rid_ = other.rid_;
+  txn_ = other.txn_;
+  strategy_ = other.strategy_;
+  page_ = other.page_;
+  other.page_ = nullptr;
+  other.Reset();
 }
 
+TableIterator::~TableIterator() { Reset(); }
+
 bool TableIterator::operator==(const TableIterator &itr) const {
   return this->rid_ == itr.rid_;
 }
@@ -33,85 +61,119 @@ bool TableIterator::operator!=(const TableIterator &itr) const {
 }
 
 const Row &TableIterator::operator*() {
-  auto page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(rid_.GetPageId()));
-  if (page == nullptr) {
-    table_heap_->buffer_pool_manager_->UnpinPage(rid_.GetPageId(), false);
-    Row *row = new Row(INVALID_ROWID);
-    return *row;
-  }
-  Row *row = new Row(rid_);
-  bool res = page->GetTuple(row, table_heap_->schema_, txn_, table_heap_->lock_manager_);
-  if(res){
-    table_heap_->buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-    return *row;
-  }else{
-    table_heap_->buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-    Row *row = new Row(INVALID_ROWID);
-    return *row;
+  ASSERT(page_ != nullptr, "Dereferencing the end of a table.");
+  if (!row_loaded_) {
+    row_.destroy();
+    row_.SetRowId(rid_);
+    page_->GetTuple(&row_, table_heap_->schema_, txn_, table_heap_->lock_manager_);
+    row_loaded_ = true;
   }
+  return row_;
 }
 
 Row *TableIterator::operator->() {
-  auto page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(rid_.GetPageId()));
-  if (page == nullptr) {
-    table_heap_->buffer_pool_manager_->UnpinPage(rid_.GetPageId(), false);
-    return nullptr;
-  }
-  Row *row = new Row(rid_);
-  bool res = page->GetTuple(row, table_heap_->schema_, txn_, table_heap_->lock_manager_);
-  if(res){
-    table_heap_->buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-    return row;
-  }else{
-    table_heap_->buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-    return nullptr;
+  return const_cast<Row *>(&**this);
+}
+
+const RowView &TableIterator::GetRowView() {
+  ASSERT(page_ != nullptr, "Reading the end of a table.");
+  view_ = RowView(page_->GetTupleData(rid_.GetSlotNum()), table_heap_->schema_, rid_);
+  return view_;
+}
+
+bool TableIterator::Seek(const RowId &rid) {
+  ASSERT(table_heap_ != nullptr, "Seeking in no table.");
+  row_loaded_ = false;
+  if (page_ == nullptr || page_->GetTablePageId() != rid.GetPageId()) {
+    if (page_ != nullptr) {
+      table_heap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+    }
+    page_ = table_heap_->FetchTablePage(rid.GetPageId(), strategy_);
+    if (page_ == nullptr) {
+      Reset();
+      return false;
+    }
   }
+  rid_ = rid;
+  return page_->GetTupleData(rid_.GetSlotNum()) != nullptr;
 }
 
 TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
+  if (this == &itr) {
+    return *this;
+  }
+  Reset();
   table_heap_ = itr.table_heap_;
   rid_ = itr.rid_;
   txn_ = itr.txn_;
+  strategy_ = itr.strategy_;
+  read_ahead_ = itr.read_ahead_;
+  if (itr.page_ != nullptr) {
+    page_ = table_heap_->FetchTablePage(rid_.GetPageId(), strategy_);
+  }
   return *this;
 }
 
-// ++iter
-TableIterator &TableIterator::operator++() {
-  auto page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(rid_.GetPageId()));
-  if (page == nullptr) {
-    table_heap_->buffer_pool_manager_->UnpinPage(rid_.GetPageId(), false);
-    this->table_heap_ = nullptr;
-    this->rid_ = RowId();
-    this->txn_ = nullptr;
+TableIterator &TableIterator::operator=(TableIterator &&itr) noexcept {
+  if (this == &itr) {
     return *this;
   }
-  bool res = page->GetNextTupleRid(rid_, &rid_);
-  if(res){
-    // ÷һҳ
-    table_heap_->buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  Reset();
+  table_heap_ = itr.table_heap_;
+  rid_ = itr.rid_;
+  txn_ = itr.txn_;
+  strategy_ = itr.strategy_;
+  read_ahead_ = itr.read_ahead_;
+  page_ = itr.page_;
+  itr.page_ = nullptr;
+  itr.Reset();
+  return *this;
+}
+
+// ++iter
+TableIterator &TableIterator::operator++() {
+  if (page_ == nullptr) {
     return *this;
-  }else{
-    // һҳ
-    page_id_t next_page_id = page->GetNextPageId();
-    if(next_page_id == INVALID_PAGE_ID){
-      this->table_heap_ = nullptr;
-      this->rid_ = RowId();
-      this->txn_ = nullptr;
-      return *this;
-    }else{
-      auto next_page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(next_page_id));
-      table_heap_->buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-      page = next_page;
-      page->GetFirstTupleRid(&rid_);
-    }
   }
-  table_heap_->buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-  return *this;  
+  row_loaded_ = false;
+  FindRow(page_->GetNextTupleRid(rid_, &rid_));
+  return *this;
 }
 
 // iter++
 TableIterator TableIterator::operator++(int) {
   TableIterator p(*this);
   ++(*this);
-  return TableIterator{p};
+  return TableIterator{std::move(p)};
+}
+
+void TableIterator::FindRow(bool found) {
+  auto buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  while (!found) {
+    page_id_t page_id = page_->GetTablePageId();
+    page_id_t next_page_id = page_->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    page_ = nullptr;
+    if (next_page_id == INVALID_PAGE_ID) {
+      Reset();
+      return;
+    }
+    page_ = table_heap_->FetchTablePage(next_page_id, strategy_);
+    if (page_ == nullptr) {
+      Reset();
+      return;
+    }
+    read_ahead_.Advance(next_page_id);
+    found = page_->GetFirstTupleRid(&rid_);
+  }
+}
+
+void TableIterator::Reset() {
+  if (page_ != nullptr) {
+    table_heap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+    page_ = nullptr;
+  }
+  rid_ = RowId();
+  row_.destroy();
+  row_loaded_ = false;
 }
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/page_trace.h"
+
+/**
+ * Replay a page trace recorded with SET page_trace = 1 against every replacement policy at several pool sizes.
+ *
+ * Usage: trace_sim <trace file> [pool size]...
+ */
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <trace file> [pool size]..." << std::endl;
+    return 1;
+  }
+  PageTraceReader reader(argv[1]);
+  if (!reader.IsOpen()) {
+    std::cerr << argv[1] << " is not a page trace." << std::endl;
+    return 1;
+  }
+  std::vector<PageTraceRecord> records;
+  PageTraceRecord record;
+  while (reader.Next(&record)) {
+    records.push_back(record);
+  }
+  std::vector<size_t> pool_sizes;
+  for (int i = 2; i < argc; i++) {
+    size_t pool_size = strtoull(argv[i], nullptr, 10);
+    if (pool_size == 0) {
+      std::cerr << "Invalid pool size " << argv[i] << "." << std::endl;
+      return 1;
+    }
+    pool_sizes.push_back(pool_size);
+  }
+  if (pool_sizes.empty()) {
+    pool_sizes = {64, 256, 1024, 4096, static_cast<size_t>(DEFAULT_BUFFER_POOL_SIZE)};
+  }
+  const std::vector<std::pair<ReplacerType, std::string>> policies = {{ReplacerType::kLRU, "LRU"},
+                                                                      {ReplacerType::kClock, "CLOCK"},
+                                                                      {ReplacerType::kLRUK, "LRU-K"},
+                                                                      {ReplacerType::kTwoQueue, "2Q"},
+                                                                      {ReplacerType::kARC, "ARC"},
+                                                                      {ReplacerType::kClockSweep, "SWEEP"}};
+
+  std::cout << records.size() << " operations." << std::endl;
+  std::cout << std::left << std::setw(8) << "Policy" << std::right << std::setw(10) << "Frames" << std::setw(12)
+            << "Hits" << std::setw(12) << "Misses" << std::setw(11) << "Hit ratio" << std::setw(12) << "Evictions"
+            << std::setw(12) << "No victim" << std::endl;
+  for (size_t pool_size : pool_sizes) {
+    for (const auto &policy : policies) {
+      TraceSimulation result = SimulateTrace(records, policy.first, pool_size);
+      std::cout << std::left << std::setw(8) << policy.second << std::right << std::setw(10) << pool_size
+                << std::setw(12) << result.hits_ << std::setw(12) << result.misses_ << std::setw(10) << std::fixed
+                << std::setprecision(2) << 100 * result.HitRatio() << "%" << std::setw(12) << result.evictions_
+                << std::setw(12) << result.no_victims_ << std::endl;
+    }
+  }
+  return 0;
+}
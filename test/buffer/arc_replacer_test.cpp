@@ -0,0 +1,58 @@
+#include "buffer/arc_replacer.h"
+
+#include "gtest/gtest.h"
+
+TEST(ARCReplacerTest, SampleTest) {
+  // 4 frames, every repeated reference counts.
+  ARCReplacer arc_replacer(4, 0);
+
+  // Scenario: load pages 10..13 into frames 0..3 and release them, they are all in T1.
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    arc_replacer.SetFramePage(frame_id, 10 + frame_id);
+    arc_replacer.Pin(frame_id);
+    arc_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(4, arc_replacer.Size());
+
+  // Scenario: pages 10 and 11 are referenced again, they move to T2.
+  for (frame_id_t frame_id = 0; frame_id < 2; frame_id++) {
+    arc_replacer.Pin(frame_id);
+    arc_replacer.Unpin(frame_id);
+  }
+
+  // With a target of 0 for T1, its pages go first, in LRU order, and are remembered in B1.
+  int value;
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  EXPECT_EQ(0, arc_replacer.GetTarget());
+
+  // Scenario: page 12 is read again while in B1, T1 was too small. The target grows and the page goes to T2.
+  arc_replacer.SetFramePage(2, 12);
+  arc_replacer.Pin(2);
+  arc_replacer.Unpin(2);
+  EXPECT_EQ(1, arc_replacer.GetTarget());
+  // Scenario: a new page 20 goes to T1, which is now within its target, so T2 gives up its LRU page.
+  arc_replacer.SetFramePage(3, 20);
+  arc_replacer.Pin(3);
+  arc_replacer.Unpin(3);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: page 10 is read again while in B2, T2 was too small. The target shrinks back.
+  arc_replacer.SetFramePage(0, 10);
+  EXPECT_EQ(0, arc_replacer.GetTarget());
+  arc_replacer.Pin(0);
+
+  // Pinned frames are never victims.
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(arc_replacer.Victim(&value));
+  arc_replacer.Unpin(0);
+  EXPECT_EQ(1, arc_replacer.Size());
+}
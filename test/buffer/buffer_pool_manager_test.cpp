@@ -1,8 +1,17 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
 #include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -71,4 +80,537 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+
+TEST(BufferPoolManagerTest, ConcurrentFetchUnpinBenchmark) {
+  const std::string db_name = "bpm_bench_test.db";
+  const size_t buffer_pool_size = 1024;
+  const int num_pages = 512;
+  const int ops_per_thread = 100000;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  ASSERT_GT(bpm->GetNumShards(), 1u);
+
+  page_id_t page_id;
+  for (int i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = page_id;
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Every page is resident, so this measures latch and page table overhead only. The best of a few runs is kept.
+  std::map<int, double> throughput;
+  for (int num_threads : {1, 2, 4, 8}) {
+    for (int run = 0; run < 3; run++) {
+      std::atomic<bool> ok{true};
+      std::vector<std::thread> threads;
+      auto start = std::chrono::steady_clock::now();
+      for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+          std::default_random_engine rng(t);
+          std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+          for (int i = 0; i < ops_per_thread; i++) {
+            page_id_t id = dist(rng);
+            Page *page = bpm->FetchPage(id);
+            if (page == nullptr || *reinterpret_cast<page_id_t *>(page->GetData()) != id) {
+              ok = false;
+              return;
+            }
+            bpm->UnpinPage(id, false);
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      ASSERT_TRUE(ok);
+      throughput[num_threads] = std::max(throughput[num_threads], num_threads * ops_per_thread / seconds);
+    }
+    std::cout << num_threads << " thread(s): " << static_cast<int64_t>(throughput[num_threads])
+              << " fetch/unpin per second" << std::endl;
+  }
+  ASSERT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+
+  // Threads on separate shards do not wait for each other, so with the cores to run them the throughput grows with
+  // them; at least half of the ideal speedup is asked for, the rest is left to noise and shared caches.
+  int num_threads = std::min(4, static_cast<int>(std::thread::hardware_concurrency()));
+  if (num_threads < 2) {
+    GTEST_SKIP() << "a single core cannot show the throughput scaling with threads";
+  }
+  EXPECT_GT(throughput[num_threads], 0.5 * num_threads * throughput[1]);
+}
+
+TEST(BufferPoolManagerTest, AccessStrategyTest) {
+  const std::string db_name = "bpm_strategy_test.db";
+  const size_t buffer_pool_size = 64;
+  const int num_pages = 256;
+  const int num_hot_pages = 16;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  page_id_t page_id;
+  {
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm.NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      *reinterpret_cast<page_id_t *>(page->GetData()) = page_id;
+      ASSERT_TRUE(bpm.UnpinPage(page_id, true));
+    }
+  }
+
+  for (bool use_strategy : {false, true}) {
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    // Scenario: a few pages are hot, then the whole file is scanned.
+    for (page_id_t i = 0; i < num_hot_pages; i++) {
+      ASSERT_NE(nullptr, bpm.FetchPage(i));
+      ASSERT_TRUE(bpm.UnpinPage(i, false));
+    }
+    {
+      std::unique_ptr<BufferAccessStrategy> strategy;
+      if (use_strategy) {
+        strategy = std::make_unique<BufferAccessStrategy>(&bpm, 8);
+      }
+      for (page_id_t i = num_hot_pages; i < num_pages; i++) {
+        auto *page = bpm.FetchPage(i, strategy.get());
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(i, *reinterpret_cast<page_id_t *>(page->GetData()));
+        ASSERT_TRUE(bpm.UnpinPage(i, false));
+      }
+    }
+    EXPECT_EQ(num_pages, bpm.GetMissCount());
+    // Scenario: the hot pages are still cached only if the scan went through its own ring.
+    size_t hits = bpm.GetHitCount();
+    for (page_id_t i = 0; i < num_hot_pages; i++) {
+      ASSERT_NE(nullptr, bpm.FetchPage(i));
+      ASSERT_TRUE(bpm.UnpinPage(i, false));
+    }
+    EXPECT_EQ(use_strategy ? num_hot_pages : 0, bpm.GetHitCount() - hits);
+    ASSERT_TRUE(bpm.CheckAllUnpinned());
+  }
+
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, FlusherTest) {
+  const std::string db_name = "bpm_flusher_test.db";
+  const size_t buffer_pool_size = 64;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  for (bool use_flusher : {false, true}) {
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    if (use_flusher) {
+      bpm.StartFlusher(std::chrono::milliseconds(1));
+    }
+    std::vector<page_id_t> page_ids;
+    page_id_t page_id;
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      ASSERT_NE(nullptr, bpm.NewPage(page_id));
+      ASSERT_TRUE(bpm.UnpinPage(page_id, true));
+      page_ids.push_back(page_id);
+    }
+    // Scenario: the writer had time to clean every frame, so new pages never wait for a write.
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    bpm.StopFlusher();
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      ASSERT_NE(nullptr, bpm.NewPage(page_id));
+      ASSERT_TRUE(bpm.UnpinPage(page_id, true));
+    }
+    EXPECT_EQ(use_flusher ? 0 : buffer_pool_size, bpm.GetDirtyEvictionCount());
+    for (auto id : page_ids) {
+      ASSERT_TRUE(bpm.DeletePage(id));
+    }
+  }
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ConcurrentFlusherTest) {
+  const std::string db_name = "bpm_concurrent_flusher_test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 64;
+  const int num_threads = 4;
+  const int num_rounds = 200;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  std::vector<page_id_t> page_ids(num_pages);
+  {
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    bpm.StartFlusher(std::chrono::milliseconds(1));
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm.NewPage(page_ids[i]);
+      ASSERT_NE(nullptr, page);
+      memset(page->GetData(), 0, PAGE_SIZE);
+      ASSERT_TRUE(bpm.UnpinPage(page_ids[i], true));
+    }
+    // Scenario: every thread owns a slot of each page and counts it up while pages are evicted and flushed.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        std::mt19937 rng(t);
+        for (int round = 0; round < num_rounds; round++) {
+          for (int i = 0; i < num_pages; i++) {
+            page_id_t id = page_ids[(i + rng()) % num_pages];
+            Page *page = nullptr;
+            while ((page = bpm.FetchPage(id)) == nullptr) {
+              std::this_thread::yield();
+            }
+            page->WLatch();
+            reinterpret_cast<uint32_t *>(page->GetData())[t]++;
+            page->WUnlatch();
+            bpm.UnpinPage(id, true);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+  // Scenario: nothing was lost, every update reached disk.
+  uint32_t total[num_threads] = {0};
+  char data[PAGE_SIZE];
+  for (auto id : page_ids) {
+    disk_manager->ReadPage(id, data);
+    for (int t = 0; t < num_threads; t++) {
+      total[t] += reinterpret_cast<uint32_t *>(data)[t];
+    }
+  }
+  for (int t = 0; t < num_threads; t++) {
+    EXPECT_EQ(static_cast<uint32_t>(num_pages * num_rounds), total[t]);
+  }
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  const std::string db_name = "bpm_prefetch_test.db";
+  const size_t buffer_pool_size = 64;
+  const int num_pages = 32;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  std::vector<page_id_t> page_ids(num_pages);
+  {
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm.NewPage(page_ids[i]);
+      ASSERT_NE(nullptr, page);
+      *reinterpret_cast<page_id_t *>(page->GetData()) = page_ids[i];
+      ASSERT_TRUE(bpm.UnpinPage(page_ids[i], true));
+    }
+  }
+
+  BufferPoolManager bpm(buffer_pool_size, disk_manager);
+  // Scenario: pages requested ahead are read by the I/O threads, unpinned.
+  for (auto id : page_ids) {
+    bpm.PrefetchPage(id);
+  }
+  for (int i = 0; i < 1000 && bpm.GetPrefetchCount() < num_pages; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(num_pages, bpm.GetPrefetchCount());
+  EXPECT_TRUE(bpm.CheckAllUnpinned());
+  char data[PAGE_SIZE];
+  ASSERT_TRUE(bpm.PeekPage(page_ids[0], data));
+  EXPECT_EQ(page_ids[0], *reinterpret_cast<page_id_t *>(data));
+
+  // Scenario: the fetches that follow are all hits, and a resident page is not read twice.
+  for (auto id : page_ids) {
+    auto *page = bpm.FetchPage(id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(id, *reinterpret_cast<page_id_t *>(page->GetData()));
+    ASSERT_TRUE(bpm.UnpinPage(id, false));
+  }
+  EXPECT_EQ(num_pages, bpm.GetHitCount());
+  EXPECT_EQ(0, bpm.GetMissCount());
+  bpm.PrefetchPage(page_ids[0]);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(num_pages, bpm.GetPrefetchCount());
+
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, DirectIOTest) {
+  const std::string db_name = "bpm_direct_test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 64;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name, true, true);
+  std::vector<page_id_t> page_ids(num_pages);
+  {
+    // Scenario: frames are aligned for direct I/O, and pages go through a pool smaller than the file.
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    bpm.StartFlusher(std::chrono::milliseconds(1));
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm.NewPage(page_ids[i]);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(page->GetData()) % PAGE_SIZE);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_ids[i]);
+      ASSERT_TRUE(bpm.UnpinPage(page_ids[i], true));
+    }
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm.FetchPage(page_ids[i]);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(page->GetData()));
+      ASSERT_TRUE(bpm.UnpinPage(page_ids[i], false));
+    }
+  }
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, FrameLayoutTest) {
+  // Scenario: a large arena starts on a huge page boundary, is zeroed, and every frame can be written.
+  const size_t num_frames = 2 * HUGE_PAGE_SIZE / PAGE_SIZE;
+  FrameArena arena(num_frames);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(arena.GetFrame(0)) % HUGE_PAGE_SIZE);
+  for (size_t i = 0; i < num_frames; i++) {
+    ASSERT_EQ(0, arena.GetFrame(i)[0]);
+    memset(arena.GetFrame(i), static_cast<int>(i), PAGE_SIZE);
+  }
+  EXPECT_EQ(static_cast<char>(num_frames - 1), arena.GetFrame(num_frames - 1)[PAGE_SIZE - 1]);
+
+  // Scenario: the metadata of two frames never shares a cache line.
+  const std::string db_name = "bpm_layout_test.db";
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  {
+    BufferPoolManager bpm(16, disk_manager);
+    EXPECT_EQ(0u, sizeof(Page) % CACHE_LINE_SIZE);
+    page_id_t page_id;
+    for (int i = 0; i < 16; i++) {
+      auto *page = bpm.NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(page) % CACHE_LINE_SIZE);
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(page->GetData()) % PAGE_SIZE);
+      ASSERT_TRUE(bpm.UnpinPage(page_id, false));
+    }
+  }
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "bpm_resize_test.db";
+  const size_t buffer_pool_size = 128;
+  const int num_pages = 256;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  std::vector<page_id_t> page_ids(num_pages);
+  {
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    ASSERT_EQ(2, bpm.GetNumShards());
+    auto new_pages = [&bpm, &page_ids](int first, int last) {
+      for (int i = first; i < last; i++) {
+        auto *page = bpm.NewPage(page_ids[i]);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), PAGE_SIZE, "page %d", page_ids[i]);
+        ASSERT_TRUE(bpm.UnpinPage(page_ids[i], true));
+      }
+    };
+
+    // Scenario: growing adds free frames, nothing resident is evicted.
+    new_pages(0, buffer_pool_size);
+    ASSERT_TRUE(bpm.Resize(num_pages));
+    EXPECT_EQ(num_pages, bpm.GetPoolSize());
+    new_pages(buffer_pool_size, num_pages);
+    EXPECT_EQ(0, bpm.GetDirtyEvictionCount());
+    for (auto id : page_ids) {
+      EXPECT_TRUE(bpm.IsResident(id));
+    }
+
+    // Scenario: shrinking waits for a pinned page past the new size, resident pages stay usable meanwhile.
+    // The pages were created in order, the last one sits in the last frame of its shard.
+    ASSERT_NE(nullptr, bpm.FetchPage(page_ids.back()));
+    std::atomic<bool> done{false};
+    bool resized = false;
+    std::thread shrinker([&bpm, &done, &resized] {
+      resized = bpm.Resize(64);
+      done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(done);
+    auto *page = bpm.FetchPage(page_ids[0]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_ids[0]), std::string(page->GetData()));
+    ASSERT_TRUE(bpm.UnpinPage(page_ids[0], false));
+    ASSERT_TRUE(bpm.UnpinPage(page_ids.back(), false));
+    shrinker.join();
+    ASSERT_TRUE(resized);
+    EXPECT_EQ(64, bpm.GetPoolSize());
+    EXPECT_TRUE(bpm.IsResident(page_ids[0]));
+    EXPECT_FALSE(bpm.IsResident(page_ids.back()));
+
+    // Scenario: the dirty pages of the dropped frames were written back.
+    for (auto id : page_ids) {
+      page = bpm.FetchPage(id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(id), std::string(page->GetData()));
+      ASSERT_TRUE(bpm.UnpinPage(id, false));
+    }
+    EXPECT_TRUE(bpm.CheckAllUnpinned());
+
+    // Scenario: sizes the shards cannot take are refused.
+    EXPECT_FALSE(bpm.Resize(1));
+    EXPECT_FALSE(bpm.Resize(bpm.GetMaxPoolSize() + 1));
+    EXPECT_EQ(64, bpm.GetPoolSize());
+  }
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, SharedPoolTest) {
+  const std::string db_names[] = {"bpm_shared_test_0.db", "bpm_shared_test_1.db"};
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 8;
+
+  auto buffer_pool = std::make_shared<BufferPool>(buffer_pool_size);
+  DiskManager *disk_managers[2];
+  BufferPoolManager *bpms[2];
+  for (int f = 0; f < 2; f++) {
+    remove(db_names[f].c_str());
+    disk_managers[f] = new DiskManager(db_names[f]);
+    bpms[f] = new BufferPoolManager(buffer_pool, disk_managers[f]);
+  }
+  EXPECT_NE(bpms[0]->GetFileId(), bpms[1]->GetFileId());
+
+  // Scenario: the same page ids of two files are different pages, and the files fill one set of frames.
+  for (int f = 0; f < 2; f++) {
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      auto *page = bpms[f]->NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      ASSERT_EQ(i, page_id);
+      snprintf(page->GetData(), PAGE_SIZE, "file %d page %d", f, page_id);
+      ASSERT_TRUE(bpms[f]->UnpinPage(page_id, true));
+    }
+  }
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpms[0]->NewPage(page_id));
+  EXPECT_EQ(1, bpms[1]->GetDirtyEvictionCount());
+  ASSERT_TRUE(bpms[0]->UnpinPage(page_id, false));
+  for (int f = 0; f < 2; f++) {
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpms[f]->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("file " + std::to_string(f) + " page " + std::to_string(i), std::string(page->GetData()));
+      ASSERT_TRUE(bpms[f]->UnpinPage(i, false));
+    }
+  }
+
+  // Scenario: closing a file writes its pages and gives its frames to the other one.
+  size_t dirty_evictions = bpms[0]->GetDirtyEvictionCount();
+  delete bpms[1];
+  for (int i = num_pages + 1; i < static_cast<int>(buffer_pool_size); i++) {
+    ASSERT_NE(nullptr, bpms[0]->NewPage(page_id));
+    ASSERT_TRUE(bpms[0]->UnpinPage(page_id, false));
+  }
+  // the frames of file 1 were enough for the new pages, nothing was written to make room
+  EXPECT_EQ(dirty_evictions, bpms[0]->GetDirtyEvictionCount());
+  bpms[1] = new BufferPoolManager(buffer_pool, disk_managers[1]);
+  for (int i = 0; i < num_pages; i++) {
+    EXPECT_FALSE(bpms[1]->IsResident(i));
+    auto *page = bpms[1]->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("file 1 page " + std::to_string(i), std::string(page->GetData()));
+    ASSERT_TRUE(bpms[1]->UnpinPage(i, false));
+  }
+
+  for (int f = 0; f < 2; f++) {
+    delete bpms[f];
+    disk_managers[f]->Close();
+    delete disk_managers[f];
+    remove(db_names[f].c_str());
+  }
+}
+
+TEST(BufferPoolManagerTest, StatsTest) {
+  const std::string db_name = "bpm_stats_test.db";
+  const size_t buffer_pool_size = 8;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  {
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    page_id_t page_id;
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      auto *page = bpm.NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      page->SetPageType(i < buffer_pool_size / 2 ? PageType::kTable : PageType::kIndexLeaf);
+      ASSERT_TRUE(bpm.UnpinPage(page_id, true));
+    }
+    BufferPoolStats stats = bpm.GetStats();
+    ASSERT_EQ(1, stats.shards_.size());
+    EXPECT_EQ(buffer_pool_size, stats.pool_size_);
+    EXPECT_EQ(buffer_pool_size, stats.shards_[0].frames_);
+    EXPECT_EQ(0, stats.shards_[0].free_frames_);
+    EXPECT_EQ(buffer_pool_size, stats.shards_[0].replacer_size_);
+    EXPECT_EQ(0, stats.Total().hits_ + stats.Total().misses_ + stats.Total().evictions_);
+
+    // Scenario: hits are counted under the type of the page.
+    for (page_id_t i = 0; i < 4; i++) {
+      ASSERT_NE(nullptr, bpm.FetchPage(i));
+      ASSERT_TRUE(bpm.UnpinPage(i, false));
+    }
+    stats = bpm.GetStats();
+    EXPECT_EQ(4, stats.Total(PageType::kTable).hits_);
+    EXPECT_EQ(4, stats.Total().hits_);
+
+    // Scenario: new pages evict the least recently used ones, the leaves, writing them back.
+    std::vector<page_id_t> catalog_pages;
+    for (int i = 0; i < 4; i++) {
+      auto *page = bpm.NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      page->SetPageType(PageType::kCatalog);
+      catalog_pages.push_back(page_id);
+    }
+    stats = bpm.GetStats();
+    EXPECT_EQ(4, stats.Total(PageType::kIndexLeaf).evictions_);
+    EXPECT_EQ(4, stats.Total(PageType::kIndexLeaf).dirty_evictions_);
+    EXPECT_EQ(4, stats.Total(PageType::kIndexLeaf).write_backs_);
+    EXPECT_EQ(0, stats.Total(PageType::kTable).evictions_);
+    EXPECT_EQ(4, stats.shards_[0].replacer_size_);
+    for (auto id : catalog_pages) {
+      ASSERT_TRUE(bpm.UnpinPage(id, false));
+    }
+
+    // Scenario: a miss is counted once the page is unpinned, under the type its owner gave it.
+    auto *page = bpm.FetchPage(4);
+    ASSERT_NE(nullptr, page);
+    page->SetPageType(PageType::kIndexLeaf);
+    EXPECT_EQ(0, bpm.GetStats().Total().misses_);
+    ASSERT_TRUE(bpm.UnpinPage(4, false));
+    stats = bpm.GetStats();
+    EXPECT_EQ(1, stats.Total(PageType::kIndexLeaf).misses_);
+    EXPECT_EQ(1, stats.Total().misses_);
+    EXPECT_EQ(1, stats.Total(PageType::kTable).evictions_);
+    EXPECT_EQ(bpm.GetMissCount(), stats.Total().misses_);
+    EXPECT_EQ(bpm.GetHitCount(), stats.Total().hits_);
+  }
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
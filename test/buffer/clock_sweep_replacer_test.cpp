@@ -0,0 +1,120 @@
+#include "buffer/clock_sweep_replacer.h"
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "gtest/gtest.h"
+
+TEST(ClockSweepReplacerTest, SampleTest) {
+  ClockSweepReplacer clock_sweep_replacer(4);
+
+  // Scenario: use frames 0..3 once, then frame 0 twice more and frame 1 once more.
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    clock_sweep_replacer.Pin(frame_id);
+    clock_sweep_replacer.Unpin(frame_id);
+  }
+  for (frame_id_t frame_id : {0, 0, 1}) {
+    clock_sweep_replacer.Pin(frame_id);
+    clock_sweep_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(4, clock_sweep_replacer.Size());
+  EXPECT_EQ(3, clock_sweep_replacer.GetUsageCount(0));
+
+  // Scenario: the hand wears the usage counts down, the frames used least reach zero first.
+  int value;
+  ASSERT_TRUE(clock_sweep_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(clock_sweep_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  EXPECT_EQ(1, clock_sweep_replacer.GetUsageCount(0));
+
+  // Scenario: pinned frames are passed by the hand.
+  clock_sweep_replacer.Pin(1);
+  ASSERT_TRUE(clock_sweep_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_EQ(0, clock_sweep_replacer.Size());
+  EXPECT_FALSE(clock_sweep_replacer.Victim(&value));
+  clock_sweep_replacer.Unpin(1);
+  clock_sweep_replacer.Unpin(1);
+  EXPECT_EQ(1, clock_sweep_replacer.Size());
+  ASSERT_TRUE(clock_sweep_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: a new page in a frame does not inherit the usage count of the previous one.
+  clock_sweep_replacer.Pin(0);
+  clock_sweep_replacer.Pin(0);
+  clock_sweep_replacer.SetFramePage(0, 42);
+  EXPECT_EQ(0, clock_sweep_replacer.GetUsageCount(0));
+
+  // Scenario: among frames at zero the preferred one is taken.
+  ClockSweepReplacer preferring_replacer(4);
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    preferring_replacer.Unpin(frame_id);
+  }
+  ASSERT_TRUE(preferring_replacer.PreferredVictim(&value, [](frame_id_t frame_id) { return frame_id == 2; }));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(preferring_replacer.PreferredVictim(&value, [](frame_id_t) { return false; }));
+  EXPECT_EQ(2, preferring_replacer.Size());
+}
+
+/**
+ * Every thread pins and unpins frames of its own slice, the hit path of a buffer pool, and looks for a victim every
+ * 64 operations, which it releases right away. The CLOCKReplacer needs a latch around every call, as in a buffer pool.
+ */
+template <typename Run>
+static void RunContention(const char *name, size_t num_frames, Run run) {
+  const int ops_per_thread = 100000;
+  for (int num_threads : {1, 2, 4, 8}) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        std::default_random_engine rng(t);
+        size_t slice = num_frames / num_threads;
+        std::uniform_int_distribution<frame_id_t> dist(t * slice, (t + 1) * slice - 1);
+        for (int i = 0; i < ops_per_thread; i++) {
+          run(dist(rng), i % 64 == 0);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ", " << num_threads << " thread(s): "
+              << static_cast<int64_t>(num_threads * ops_per_thread / seconds) << " pin/unpin per second" << std::endl;
+  }
+}
+
+TEST(ClockSweepReplacerTest, ContentionBenchmark) {
+  const size_t num_frames = 256;
+
+  CLOCKReplacer clock_replacer(num_frames);
+  std::mutex latch;
+  RunContention("CLOCK with latch", num_frames, [&](frame_id_t frame_id, bool victim) {
+    std::lock_guard<std::mutex> guard(latch);
+    clock_replacer.Pin(frame_id);
+    clock_replacer.Unpin(frame_id);
+    frame_id_t victim_id;
+    if (victim && clock_replacer.Victim(&victim_id)) {
+      clock_replacer.Unpin(victim_id);
+    }
+  });
+
+  ClockSweepReplacer clock_sweep_replacer(num_frames);
+  RunContention("Clock sweep", num_frames, [&](frame_id_t frame_id, bool victim) {
+    clock_sweep_replacer.Pin(frame_id);
+    clock_sweep_replacer.Unpin(frame_id);
+    frame_id_t victim_id;
+    if (victim && clock_sweep_replacer.Victim(&victim_id)) {
+      clock_sweep_replacer.Unpin(victim_id);
+    }
+  });
+  // every frame was released last, by its owner or by the thread that took it as victim
+  EXPECT_EQ(num_frames, clock_sweep_replacer.Size());
+}
@@ -0,0 +1,137 @@
+#include "buffer/compressed_page_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/lz_codec.h"
+#include "gtest/gtest.h"
+
+TEST(CompressedPageCacheTest, CodecTest) {
+  std::default_random_engine rng(0);
+  std::vector<char> compressed(LZCodec::MaxCompressedSize(PAGE_SIZE));
+  std::vector<char> restored(PAGE_SIZE);
+
+  // Scenario: a page of char(N) fields, short values padded with zeros, shrinks a lot.
+  std::vector<char> padded(PAGE_SIZE, 0);
+  for (int offset = 0; offset + 64 <= PAGE_SIZE; offset += 64) {
+    snprintf(padded.data() + offset, 64, "name-%d", offset);
+  }
+  size_t size = LZCodec::Compress(padded.data(), PAGE_SIZE, compressed.data(), compressed.size());
+  ASSERT_NE(0, size);
+  EXPECT_LT(size, PAGE_SIZE / 4);
+  ASSERT_TRUE(LZCodec::Decompress(compressed.data(), size, restored.data(), PAGE_SIZE));
+  EXPECT_EQ(0, memcmp(padded.data(), restored.data(), PAGE_SIZE));
+
+  // Scenario: random bytes do not compress, they round-trip if there is room and are abandoned if there is not.
+  std::vector<char> noise(PAGE_SIZE);
+  for (auto &byte : noise) {
+    byte = static_cast<char>(rng());
+  }
+  size = LZCodec::Compress(noise.data(), PAGE_SIZE, compressed.data(), compressed.size());
+  ASSERT_NE(0, size);
+  ASSERT_TRUE(LZCodec::Decompress(compressed.data(), size, restored.data(), PAGE_SIZE));
+  EXPECT_EQ(0, memcmp(noise.data(), restored.data(), PAGE_SIZE));
+  EXPECT_EQ(0, LZCodec::Compress(noise.data(), PAGE_SIZE, compressed.data(), PAGE_SIZE / 2));
+
+  // Scenario: truncated input and a wrong original size are refused.
+  size = LZCodec::Compress(padded.data(), PAGE_SIZE, compressed.data(), compressed.size());
+  EXPECT_FALSE(LZCodec::Decompress(compressed.data(), size / 2, restored.data(), PAGE_SIZE));
+  EXPECT_FALSE(LZCodec::Decompress(compressed.data(), size, restored.data(), PAGE_SIZE - 1));
+
+  // Scenario: tiny inputs are all literals.
+  size = LZCodec::Compress("abc", 3, compressed.data(), compressed.size());
+  ASSERT_TRUE(LZCodec::Decompress(compressed.data(), size, restored.data(), 3));
+  EXPECT_EQ(0, memcmp("abc", restored.data(), 3));
+}
+
+TEST(CompressedPageCacheTest, SampleTest) {
+  std::vector<char> data(PAGE_SIZE, 0);
+  std::vector<char> restored(PAGE_SIZE);
+  CompressedPageCache disabled;
+  EXPECT_FALSE(disabled.Insert(1, data.data()));
+
+  // Scenario: pages are taken back once, the cache is exclusive.
+  CompressedPageCache cache(PAGE_SIZE);
+  for (page_tag_t page_tag = 0; page_tag < 4; page_tag++) {
+    data[0] = static_cast<char>(page_tag);
+    ASSERT_TRUE(cache.Insert(page_tag, data.data()));
+  }
+  EXPECT_EQ(4, cache.GetPageCount());
+  ASSERT_TRUE(cache.Take(2, restored.data()));
+  EXPECT_EQ(2, restored[0]);
+  EXPECT_FALSE(cache.Take(2, restored.data()));
+
+  // Scenario: shrinking drops the oldest pages, erasing a file drops all of its pages.
+  cache.SetCapacity(cache.GetSize() - 1);
+  EXPECT_EQ(2, cache.GetPageCount());
+  EXPECT_FALSE(cache.Take(0, restored.data()));
+  cache.Insert(static_cast<page_tag_t>(1) << 32 | 5, data.data());
+  cache.EraseFile(0);
+  EXPECT_EQ(1, cache.GetPageCount());
+  EXPECT_FALSE(cache.Take(3, restored.data()));
+  EXPECT_TRUE(cache.Take(static_cast<page_tag_t>(1) << 32 | 5, restored.data()));
+  EXPECT_EQ(0, cache.GetSize());
+}
+
+TEST(CompressedPageCacheTest, BufferPoolTest) {
+  const std::string db_name = "compressed_cache_test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 32;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  {
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    bpm.GetBufferPool()->SetCompressedCacheSize(num_pages * PAGE_SIZE / 2);
+    std::vector<page_id_t> page_ids;
+    page_id_t page_id;
+    for (int i = 0; i < num_pages; i++) {
+      auto *page = bpm.NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+      ASSERT_TRUE(bpm.UnpinPage(page_id, true));
+      page_ids.push_back(page_id);
+    }
+
+    // Scenario: every fetch of a page evicted by the small pool is served from the compressed cache.
+    for (auto id : page_ids) {
+      auto *page = bpm.FetchPage(id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(id), std::string(page->GetData()));
+      ASSERT_TRUE(bpm.UnpinPage(id, false));
+    }
+    BufferPoolStats stats = bpm.GetStats();
+    size_t compressed_hits = 0;
+    for (const auto &shard : stats.shards_) {
+      compressed_hits += shard.compressed_hits_;
+    }
+    EXPECT_GE(compressed_hits, num_pages - buffer_pool_size);
+    EXPECT_EQ(stats.Total().misses_, compressed_hits);
+
+    // Scenario: a deleted and reallocated page comes back empty, not as the copy cached before.
+    page_id_t victim = page_ids[0];
+    ASSERT_FALSE(bpm.IsResident(victim));
+    ASSERT_TRUE(bpm.DeletePage(victim));
+    ASSERT_NE(nullptr, bpm.NewPage(page_id));
+    ASSERT_EQ(victim, page_id);
+    ASSERT_TRUE(bpm.UnpinPage(page_id, true));
+    // clean victims are preferred, write the page so that it goes as soon as it is the least recently used
+    ASSERT_TRUE(bpm.FlushPage(page_id));
+    for (size_t i = 1; i < page_ids.size(); i++) {
+      ASSERT_NE(nullptr, bpm.FetchPage(page_ids[i]));
+      ASSERT_TRUE(bpm.UnpinPage(page_ids[i], false));
+    }
+    ASSERT_FALSE(bpm.IsResident(victim));
+    auto *page = bpm.FetchPage(victim);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, page->GetData()[0]);
+    ASSERT_TRUE(bpm.UnpinPage(victim, false));
+  }
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,77 @@
+#include "buffer/lru_k_replacer.h"
+
+#include "gtest/gtest.h"
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 0);
+
+  // Scenario: reference frames 1, 2, 3 once and frame 1 a second time.
+  for (frame_id_t frame_id : {1, 2, 3, 1}) {
+    lru_k_replacer.Pin(frame_id);
+    lru_k_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(3, lru_k_replacer.Size());
+
+  // Scenario: frames referenced only once have an infinite backward distance and go first, in LRU order.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+
+  // Scenario: pinned frames are never victims.
+  lru_k_replacer.Unpin(4);
+  lru_k_replacer.Unpin(5);
+  lru_k_replacer.Pin(4);
+  EXPECT_EQ(1, lru_k_replacer.Size());
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+}
+
+TEST(LRUKReplacerTest, CorrelatedReferenceTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 4);
+
+  // Scenario: frame 1 is touched twice far apart, frame 2 many times in a row like a scanned page.
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  for (int i = 0; i < 10; i++) {
+    lru_k_replacer.Pin(2);
+    lru_k_replacer.Unpin(2);
+  }
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+
+  // The burst on frame 2 counts as a single reference.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+}
+
+TEST(LRUKReplacerTest, RetainedHistoryTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 0);
+
+  // Scenario: page 100 is referenced and evicted, its history survives the eviction.
+  lru_k_replacer.SetFramePage(1, 100);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+
+  // Scenario: page 100 comes back in another frame and now has two references, page 200 only one.
+  lru_k_replacer.SetFramePage(2, 100);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.SetFramePage(3, 200);
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Unpin(3);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+}
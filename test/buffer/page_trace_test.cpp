@@ -0,0 +1,83 @@
+#include "buffer/page_trace.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+TEST(PageTraceTest, RecordAndReplayTest) {
+  const std::string db_name = "page_trace_test.db";
+  const std::string trace_name = "page_trace_test.bin";
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 8;
+  const int rounds = 4;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  {
+    BufferPoolManager bpm(buffer_pool_size, disk_manager);
+    // operations before the trace is started are not recorded
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm.NewPage(page_id));
+    ASSERT_TRUE(bpm.UnpinPage(page_id, false));
+
+    // Scenario: every new page, fetch and unpin is recorded in order.
+    ASSERT_TRUE(bpm.StartTrace(trace_name));
+    std::vector<page_id_t> page_ids;
+    for (int i = 0; i < num_pages; i++) {
+      ASSERT_NE(nullptr, bpm.NewPage(page_id));
+      ASSERT_TRUE(bpm.UnpinPage(page_id, true));
+      page_ids.push_back(page_id);
+    }
+    for (int round = 0; round < rounds; round++) {
+      for (auto id : page_ids) {
+        ASSERT_NE(nullptr, bpm.FetchPage(id));
+        ASSERT_TRUE(bpm.UnpinPage(id, false));
+      }
+    }
+    EXPECT_EQ(2 * num_pages * (rounds + 1), bpm.StopTrace());
+    // operations after the trace is stopped are not recorded either
+    ASSERT_NE(nullptr, bpm.FetchPage(page_ids[0]));
+    ASSERT_TRUE(bpm.UnpinPage(page_ids[0], false));
+    EXPECT_EQ(0, bpm.StopTrace());
+  }
+  disk_manager->Close();
+  delete disk_manager;
+  remove(db_name.c_str());
+
+  PageTraceReader reader(trace_name);
+  ASSERT_TRUE(reader.IsOpen());
+  std::vector<PageTraceRecord> records;
+  PageTraceRecord record;
+  while (reader.Next(&record)) {
+    records.push_back(record);
+  }
+  ASSERT_EQ(2 * num_pages * (rounds + 1), records.size());
+  EXPECT_EQ(PageTraceOp::kNew, records[0].op_);
+  EXPECT_EQ(PageTraceOp::kUnpin, records[1].op_);
+  EXPECT_EQ(records[0].page_id_, records[1].page_id_);
+  EXPECT_EQ(PageTraceOp::kFetch, records[2 * num_pages].op_);
+  for (size_t i = 1; i < records.size(); i++) {
+    EXPECT_LE(records[i - 1].timestamp_, records[i].timestamp_);
+    EXPECT_EQ(records[0].thread_, records[i].thread_);
+  }
+
+  // Scenario: the trace cycles through more pages than a small pool holds, LRU never hits there.
+  for (auto replacer_type : {ReplacerType::kLRU, ReplacerType::kClock, ReplacerType::kLRUK, ReplacerType::kTwoQueue,
+                             ReplacerType::kARC, ReplacerType::kClockSweep}) {
+    TraceSimulation large = SimulateTrace(records, replacer_type, num_pages);
+    EXPECT_EQ(num_pages, large.new_pages_);
+    EXPECT_EQ(num_pages * rounds, large.hits_);
+    EXPECT_EQ(0, large.misses_);
+    EXPECT_EQ(0, large.evictions_);
+    TraceSimulation small = SimulateTrace(records, replacer_type, num_pages / 2);
+    EXPECT_EQ(num_pages * rounds, small.hits_ + small.misses_);
+    EXPECT_EQ(0, small.no_victims_);
+    if (replacer_type == ReplacerType::kLRU) {
+      EXPECT_EQ(0, small.hits_);
+    }
+  }
+  remove(trace_name.c_str());
+}
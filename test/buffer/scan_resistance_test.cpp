@@ -0,0 +1,127 @@
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "page/index_roots_page.h"
+#include "storage/table_heap.h"
+
+static const std::string db_name = "scan_resistance_test.db";
+
+TEST(ScanResistanceTest, IndexPagesSurviveTableScan) {
+  const int row_nums = 10000;
+  const size_t pool_size = 32;
+  const int pages_between_lookups = 32;
+
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns);
+  std::vector<uint32_t> key_map{0};
+  auto *key_schema = Schema::ShallowCopySchema(&schema, key_map);
+  KeyManager KP(key_schema, 16);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+
+  // Build a table of a few hundred pages and an index on it with a pool that holds everything.
+  page_id_t first_page_id;
+  {
+    BufferPoolManager bpm(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+    page_id_t id;
+    ASSERT_NE(nullptr, bpm.NewPage(id));
+    ASSERT_EQ(CATALOG_META_PAGE_ID, id);
+    bpm.UnpinPage(id, true);
+    ASSERT_NE(nullptr, bpm.NewPage(id));
+    ASSERT_EQ(INDEX_ROOTS_PAGE_ID, id);
+    bpm.UnpinPage(id, true);
+    TableHeap *table_heap = TableHeap::Create(&bpm, &schema, nullptr, nullptr, nullptr);
+    BPlusTree tree(0, &bpm, KP);
+    GenericKey *key = KP.InitKey();
+    for (int i = 0; i < row_nums; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 60, true)};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+      KP.SerializeFromKey(key, Row(key_fields), key_schema);
+      ASSERT_TRUE(tree.Insert(key, row.GetRowId()));
+    }
+    free(key);
+    first_page_id = table_heap->GetFirstPageId();
+    delete table_heap;
+  }
+
+  std::vector<GenericKey *> hot_keys;
+  for (int i = 0; i < 8; i++) {
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, i * (row_nums / 8) + 7)};
+    hot_keys.push_back(KP.InitKey());
+    KP.SerializeFromKey(hot_keys.back(), Row(key_fields), key_schema);
+  }
+
+  // Scan the whole table through a small pool and look the hot keys up every few pages.
+  for (auto replacer_type : {ReplacerType::kLRU, ReplacerType::kLRUK, ReplacerType::kTwoQueue}) {
+    BufferPoolManager bpm(pool_size, disk_mgr, replacer_type);
+    TableHeap *table_heap = TableHeap::Create(&bpm, first_page_id, &schema, nullptr, nullptr);
+    BPlusTree tree(0, &bpm, KP);
+
+    // pages a lookup of the hot keys goes through
+    std::set<page_id_t> hot_pages;
+    page_id_t root_page_id;
+    auto *roots_page = reinterpret_cast<IndexRootsPage *>(bpm.FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    ASSERT_TRUE(roots_page->GetRootId(0, &root_page_id));
+    bpm.UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+    hot_pages.insert(root_page_id);
+    for (auto *key : hot_keys) {
+      Page *leaf = tree.FindLeafPage(key);
+      hot_pages.insert(leaf->GetPageId());
+      bpm.UnpinPage(leaf->GetPageId(), false);
+    }
+
+    int pages = 0;
+    int batches = 0;
+    int resident_batches = 0;
+    page_id_t current_page_id = INVALID_PAGE_ID;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      page_id_t page_id = iter->GetRowId().GetPageId();
+      if (page_id == current_page_id) {
+        continue;
+      }
+      current_page_id = page_id;
+      if (pages++ % pages_between_lookups != 0) {
+        continue;
+      }
+      // the first two batches teach the replacer that these pages are re-referenced
+      if (batches++ >= 2) {
+        bool all_resident = true;
+        for (auto hot_page_id : hot_pages) {
+          all_resident &= bpm.IsResident(hot_page_id);
+        }
+        resident_batches += all_resident ? 1 : 0;
+      }
+      for (auto *key : hot_keys) {
+        std::vector<RowId> result;
+        ASSERT_TRUE(tree.GetValue(key, result));
+      }
+    }
+    ASSERT_GT(batches, 4);
+    if (replacer_type == ReplacerType::kLRU) {
+      // the scan pushes everything out between two lookups
+      EXPECT_EQ(0, resident_batches);
+    } else {
+      EXPECT_EQ(batches - 2, resident_batches);
+    }
+    ASSERT_TRUE(bpm.CheckAllUnpinned());
+    delete table_heap;
+  }
+
+  for (auto *key : hot_keys) {
+    free(key);
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
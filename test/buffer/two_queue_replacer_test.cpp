@@ -0,0 +1,50 @@
+#include "buffer/two_queue_replacer.h"
+
+#include "gtest/gtest.h"
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // 8 frames: A1in keeps 2 frames before it gives any up, A1out remembers 8 pages.
+  TwoQueueReplacer two_queue_replacer(8);
+
+  // Scenario: load pages 10..13 into frames 0..3 and release them.
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    two_queue_replacer.SetFramePage(frame_id, 10 + frame_id);
+    two_queue_replacer.Pin(frame_id);
+    two_queue_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(4, two_queue_replacer.Size());
+
+  // Scenario: hits in A1in do not reorder it, the victims come out in load order.
+  two_queue_replacer.Pin(0);
+  two_queue_replacer.Unpin(0);
+  int value;
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+
+  // Scenario: page 10 is read again while it is in A1out, so it goes to Am.
+  two_queue_replacer.SetFramePage(0, 10);
+  two_queue_replacer.Pin(0);
+  two_queue_replacer.Unpin(0);
+  // Scenario: new pages 20, 21 go to A1in.
+  for (frame_id_t frame_id = 1; frame_id < 3; frame_id++) {
+    two_queue_replacer.SetFramePage(frame_id + 3, 19 + frame_id);
+    two_queue_replacer.Pin(frame_id + 3);
+    two_queue_replacer.Unpin(frame_id + 3);
+  }
+
+  // A1in holds pages 12, 13, 20, 21, more than its share, so it gives up its oldest pages before Am does.
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  // A1in is down to its share: now Am is the victim, A1in is only drained below its share when Am is empty.
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(two_queue_replacer.Victim(&value));
+}
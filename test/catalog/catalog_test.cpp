@@ -1,7 +1,10 @@
 #include "catalog/catalog.h"
 
+#include <sys/stat.h>
+
 #include "common/instance.h"
 #include "gtest/gtest.h"
+#include "page/index_roots_page.h"
 #include "utils/utils.h"
 
 static string db_file_name = "catalog_test.db";
@@ -126,4 +129,248 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, TablespaceTest) {
+  const string db_name = "catalog_tablespace_test.db";
+  const int num_rows = 2000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<std::string> index_keys{"id"};
+  Txn txn;
+  auto insert_rows = [&](TableInfo *table_info, IndexInfo *index_info, int from, int to) {
+    for (int i = from; i < to; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                                Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true)};
+      Row row(fields);
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+      // Scenario: every page of the table is in the data file it was placed in.
+      ASSERT_EQ(1, DiskManager::DataFileOf(row.GetRowId().GetPageId()));
+      std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+      Row key(key_fields);
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, row.GetRowId(), &txn));
+    }
+  };
+  auto index_root = [](DBStorageEngine *db) {
+    page_id_t root_page_id = INVALID_PAGE_ID;
+    auto *page = db->bpm_->FetchPage(INDEX_ROOTS_PAGE_ID);
+    reinterpret_cast<IndexRootsPage *>(page->GetData())->GetRootId(0, &root_page_id);
+    db->bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+    return root_page_id;
+  };
+
+  auto db_01 = new DBStorageEngine(db_name, true);
+  ASSERT_EQ(1, db_01->disk_mgr_->AddDataFile("./databases/." + db_name + ".1"));
+  ASSERT_EQ(2, db_01->disk_mgr_->AddDataFile("./databases/." + db_name + ".2"));
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info, 1));
+  ASSERT_EQ(DB_SUCCESS,
+            db_01->catalog_mgr_->CreateIndex("table-1", "index-1", index_keys, &txn, index_info, "bptree", 2));
+  insert_rows(table_info, index_info, 0, num_rows / 2);
+  // Scenario: the nodes of the index are in the other data file.
+  EXPECT_EQ(2, DiskManager::DataFileOf(index_root(db_01)));
+  delete db_01;
+
+  // Scenario: the data files come back with the database, and the objects keep growing in theirs.
+  auto db_02 = new DBStorageEngine(db_name, false);
+  ASSERT_EQ(3, db_02->disk_mgr_->GetDataFileCount());
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info));
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-1", index_info));
+  insert_rows(table_info, index_info, num_rows / 2, num_rows);
+  EXPECT_EQ(2, DiskManager::DataFileOf(index_root(db_02)));
+  std::vector<RowId> result;
+  for (int i = 0; i < num_rows; i++) {
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+    Row key(key_fields);
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, result, &txn));
+  }
+  EXPECT_EQ(num_rows, result.size());
+  delete db_02;
+  DiskManager::RemoveFiles("./databases/" + db_name);
+}
+
+TEST(CatalogTest, VacuumTest) {
+  const string db_name = "catalog_vacuum_test.db";
+  const int num_rows = 4000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<std::string> index_keys{"id"};
+  Txn txn;
+  auto file_size = [&]() {
+    struct stat stat_buf;
+    stat(("./databases/" + db_name).c_str(), &stat_buf);
+    return stat_buf.st_size;
+  };
+  auto check_rows = [&](DBStorageEngine *db) {
+    TableInfo *table_info = nullptr;
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, db->catalog_mgr_->GetTable("table-1", table_info));
+    ASSERT_EQ(DB_SUCCESS, db->catalog_mgr_->GetIndex("table-1", "index-1", index_info));
+    int count = 0;
+    for (auto it = table_info->GetTableHeap()->Begin(&txn); it != table_info->GetTableHeap()->End(); ++it) {
+      count++;
+    }
+    EXPECT_EQ(num_rows / 4, count);
+    for (int i = 0; i < num_rows; i++) {
+      std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+      Row key(key_fields);
+      std::vector<RowId> result;
+      if (i % 4 != 0) {
+        EXPECT_EQ(DB_KEY_NOT_FOUND, index_info->GetIndex()->ScanKey(key, result, &txn));
+        continue;
+      }
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, result, &txn));
+      Row row(result[0]);
+      ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, &txn));
+      EXPECT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(key_fields[0]));
+    }
+  };
+
+  // a small pool writes the pages out as they are filled, so that the file has its full size before the vacuum
+  auto db_01 = new DBStorageEngine(db_name, true, 32);
+  TableInfo *table_info = nullptr;
+  TableInfo *dropped_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-1", index_keys, &txn, index_info, "bptree"));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-2", schema.get(), &txn, dropped_info));
+  std::vector<RowId> deleted;
+  for (int i = 0; i < num_rows; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+    if (i % 4 != 0) {
+      deleted.push_back(row.GetRowId());
+    } else {
+      std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+      Row key(key_fields);
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, row.GetRowId(), &txn));
+    }
+    Row other(fields);
+    ASSERT_TRUE(dropped_info->GetTableHeap()->InsertTuple(other, &txn));
+  }
+  for (const auto &rid : deleted) {
+    ASSERT_TRUE(table_info->GetTableHeap()->MarkDelete(rid, &txn));
+    table_info->GetTableHeap()->ApplyDelete(rid, &txn);
+  }
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->DropTable("table-2"));
+  auto size_before = file_size();
+
+  // Scenario: the pages of the dropped table and the holes of the deleted rows are cut off the file.
+  uint64_t released_pages = 0;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->Vacuum(&txn, released_pages));
+  EXPECT_GT(released_pages, 0);
+  EXPECT_LT(file_size(), size_before);
+  EXPECT_LE(file_size(), size_before - static_cast<int64_t>(released_pages) * PAGE_SIZE);
+  check_rows(db_01);
+  delete db_01;
+
+  // Scenario: the compacted database opens again with its rows and index entries.
+  auto db_02 = new DBStorageEngine(db_name, false);
+  check_rows(db_02);
+  delete db_02;
+  DiskManager::RemoveFiles("./databases/" + db_name);
+}
+
+TEST(CatalogTest, VacuumFailureTest) {
+  const string db_name = "catalog_vacuum_failure_test.db";
+  const int num_rows = 100;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<std::string> index_keys{"id"};
+  Txn txn;
+  auto db_01 = new DBStorageEngine(db_name, true, 32);
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-1", index_keys, &txn, index_info, "bptree"));
+  for (int i = 0; i <= num_rows; i++) {
+    // the last row repeats a key the index has already, its entry cannot be copied
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i % num_rows),
+                              Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+    if (i < num_rows) {
+      std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+      Row key(key_fields);
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, row.GetRowId(), &txn));
+    }
+  }
+  page_id_t first_page_id = table_info->GetTableHeap()->GetFirstPageId();
+
+  // Scenario: the rebuild fails and the table keeps its heap, its rows and its index entries.
+  uint64_t released_pages = 0;
+  ASSERT_EQ(DB_FAILED, db_01->catalog_mgr_->Vacuum(&txn, released_pages));
+  EXPECT_EQ(first_page_id, table_info->GetTableHeap()->GetFirstPageId());
+  int count = 0;
+  for (auto it = table_info->GetTableHeap()->Begin(&txn); it != table_info->GetTableHeap()->End(); ++it) {
+    count++;
+  }
+  EXPECT_EQ(num_rows + 1, count);
+  for (int i = 0; i < num_rows; i++) {
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+    Row key(key_fields);
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, result, &txn));
+    Row row(result[0]);
+    ASSERT_TRUE(table_info->GetTableHeap()->GetTuple(&row, &txn));
+    EXPECT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(key_fields[0]));
+  }
+
+  // Scenario: the copies are gone, only the index has a root left in the index roots page.
+  auto *page = db_01->bpm_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  EXPECT_EQ(1, reinterpret_cast<IndexRootsPage *>(page->GetData())->GetIndexCount());
+  db_01->bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  delete db_01;
+  DiskManager::RemoveFiles("./databases/" + db_name);
+}
+
+TEST(CatalogTest, VacuumIndexDeleteTest) {
+  const string db_name = "catalog_vacuum_index_test.db";
+  const int num_rows = 2000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 200, 1, false, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<std::string> index_keys{"name"};
+  Txn txn;
+  auto file_size = [&]() {
+    struct stat stat_buf;
+    stat(("./databases/" + db_name).c_str(), &stat_buf);
+    return stat_buf.st_size;
+  };
+  auto db_01 = new DBStorageEngine(db_name, true, 32);
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-1", index_keys, &txn, index_info, "bptree"));
+  std::vector<Row> keys;
+  for (int i = 0; i < num_rows; i++) {
+    std::string name = "name-" + std::to_string(i);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+    std::vector<Field> key_fields{Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    keys.emplace_back(key_fields);
+    keys.back().SetRowId(row.GetRowId());
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(keys.back(), row.GetRowId(), &txn));
+  }
+  auto size_before = file_size();
+
+  // Scenario: the nodes merged away by deletes are freed, with the rest of the table they leave nothing behind.
+  for (int i = num_rows / 20; i < num_rows; i++) {
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->RemoveEntry(keys[i], keys[i].GetRowId(), &txn));
+  }
+  EXPECT_TRUE(db_01->bpm_->CheckAllUnpinned());
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->DropIndex("table-1", "index-1"));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->DropTable("table-1"));
+  uint64_t released_pages = 0;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->Vacuum(&txn, released_pages));
+  EXPECT_LT(file_size(), size_before / 10);
+  delete db_01;
+  DiskManager::RemoveFiles("./databases/" + db_name);
+}
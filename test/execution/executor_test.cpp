@@ -112,6 +112,43 @@ TEST_F(ExecutorTest, SimpleRawInsertTest) {
   ASSERT_TRUE(result_set[0].GetField(2)->CompareEquals(Field(kTypeFloat, static_cast<float>(2.33))));
 }
 
+// INSERT INTO table-1 VALUES (2000, "aaa", 2.33), ..., (2000, "aaa", 2.33);
+TEST_F(ExecutorTest, DuplicateInsertTest) {
+  TableInfo *table_info;
+  GetExecutorContext()->GetCatalog()->GetTable("table-1", table_info);
+  const Schema *schema = table_info->GetSchema();
+  IndexInfo *index_info = nullptr;
+  std::vector<std::string> index_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, GetExecutorContext()->GetCatalog()->CreateIndex("table-1", "index-1", index_keys, GetTxn(),
+                                                                         index_info, "bptree"));
+  auto col_a = MakeColumnValueExpression(*schema, 0, "id");
+  auto const2000 = MakeConstantValueExpression(Field(kTypeInt, 2000));
+  auto scan_plan = make_shared<SeqScanPlanNode>(schema, table_info->GetTableName(),
+                                                MakeComparisonExpression(col_a, const2000, ">="));
+
+  // Scenario: a row by row insert and a batch insert both undo every row when the last one repeats the first key.
+  for (size_t num_rows : {size_t{2}, static_cast<size_t>(BULK_INSERT_MIN_ROWS) + 1}) {
+    std::vector<std::vector<AbstractExpressionRef>> raw_values;
+    for (size_t i = 0; i < num_rows; i++) {
+      int id = i + 1 < num_rows ? static_cast<int>(2000 + i) : 2000;
+      raw_values.push_back({MakeConstantValueExpression(Field(kTypeInt, id)),
+                            MakeConstantValueExpression(Field(kTypeChar, const_cast<char *>("aaa"), 3, false)),
+                            MakeConstantValueExpression(Field(kTypeFloat, static_cast<float>(2.33)))});
+    }
+    auto value_plan = std::make_shared<ValuesPlanNode>(nullptr, raw_values);
+    auto insert_plan = std::make_shared<InsertPlanNode>(nullptr, value_plan, "table-1");
+    std::vector<Row> result_set{};
+    EXPECT_EQ(DB_FAILED, GetExecutionEngine()->ExecutePlan(insert_plan, &result_set, GetTxn(), GetExecutorContext()));
+    EXPECT_TRUE(result_set.empty());
+
+    GetExecutionEngine()->ExecutePlan(scan_plan, &result_set, GetTxn(), GetExecutorContext());
+    EXPECT_TRUE(result_set.empty());
+    std::vector<Field> key_fields{Field(kTypeInt, 2000)};
+    std::vector<RowId> rids{};
+    EXPECT_EQ(DB_KEY_NOT_FOUND, index_info->GetIndex()->ScanKey(Row(key_fields), rids, GetTxn()));
+  }
+}
+
 // UPDATE table-1 SET name = "minisql" where id = 500;
 TEST_F(ExecutorTest, SimpleUpdateTest) {
   // Construct a sequential scan of the table
@@ -5,6 +5,7 @@
 #include "page/table_page.h"
 #include "record/field.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 char *chars[] = {const_cast<char *>(""), const_cast<char *>("hello"), const_cast<char *>("world!"),
@@ -100,4 +101,108 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+TEST(TupleTest, RowViewTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false),
+                                   new Column("note", TypeId::kTypeChar, 16, 3, true, false),
+                                   new Column("age", TypeId::kTypeInt, 4, true, false)};
+  Schema schema(columns);
+  EXPECT_EQ(sizeof(uint32_t) + 1, schema.GetRowHeaderSize());
+  EXPECT_EQ(schema.GetRowHeaderSize() + sizeof(int32_t), schema.GetFixedOffset(1));
+  EXPECT_EQ(Schema::VARIABLE_OFFSET, schema.GetFixedOffset(2));
+  char buf[PAGE_SIZE];
+
+  // Scenario: every column reads back as it was written, in any order and without nulls or with them.
+  std::vector<std::vector<Field>> rows = {
+      {Field(TypeId::kTypeInt, 188), Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, false),
+       Field(TypeId::kTypeFloat, 19.99f), Field(TypeId::kTypeChar, const_cast<char *>("x"), 1, false),
+       Field(TypeId::kTypeInt, 20)},
+      {Field(TypeId::kTypeInt), Field(TypeId::kTypeChar), Field(TypeId::kTypeFloat, 1.5f),
+       Field(TypeId::kTypeChar, const_cast<char *>("note"), 4, false), Field(TypeId::kTypeInt)}};
+  for (auto &fields : rows) {
+    Row row(fields);
+    uint32_t size = row.SerializeTo(buf, &schema);
+    RowView view(buf, &schema, RowId(1, 2));
+    EXPECT_EQ(size, view.GetSerializedSize());
+    EXPECT_EQ(RowId(1, 2), view.GetRowId());
+    for (int i = static_cast<int>(fields.size()) - 1; i >= 0; i--) {
+      EXPECT_EQ(fields[i].IsNull(), view.IsNull(i));
+      Field field = view.GetField(i);
+      if (fields[i].IsNull()) {
+        EXPECT_TRUE(field.IsNull());
+      } else {
+        EXPECT_EQ(CmpBool::kTrue, field.CompareEquals(fields[i]));
+      }
+    }
+
+    // Scenario: the decoded rows own their fields, they outlive the bytes they were read from.
+    Row decoded;
+    Row projected;
+    view.GetRow(&decoded);
+    view.GetRow({3, 0}, &projected);
+    memset(buf, 0, sizeof(buf));
+    ASSERT_EQ(fields.size(), decoded.GetFieldCount());
+    for (size_t i = 0; i < fields.size(); i++) {
+      EXPECT_EQ(fields[i].IsNull(), decoded.GetField(i)->IsNull());
+      if (!fields[i].IsNull()) {
+        EXPECT_EQ(CmpBool::kTrue, decoded.GetField(i)->CompareEquals(fields[i]));
+      }
+    }
+    ASSERT_EQ(2, projected.GetFieldCount());
+    EXPECT_EQ(CmpBool::kTrue, projected.GetField(0)->CompareEquals(fields[3]));
+  }
+}
+
+TEST(TupleTest, RowCodecTest) {
+  std::vector<Column *> fixed_columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                         new Column("account", TypeId::kTypeFloat, 1, true, false),
+                                         new Column("age", TypeId::kTypeInt, 2, true, false)};
+  Schema fixed_schema(fixed_columns);
+  EXPECT_TRUE(fixed_schema.GetCodec().IsFixedWidth());
+  char buf[PAGE_SIZE];
+
+  // Scenario: a fixed-width row without nulls has the size of the schema, with nulls it is shorter.
+  std::vector<std::vector<Field>> rows = {
+      {Field(TypeId::kTypeInt, -7), Field(TypeId::kTypeFloat, 2.25f), Field(TypeId::kTypeInt, 30)},
+      {Field(TypeId::kTypeInt, 8), Field(TypeId::kTypeFloat), Field(TypeId::kTypeInt, 31)}};
+  std::vector<uint32_t> sizes = {fixed_schema.GetRowHeaderSize() + 12, fixed_schema.GetRowHeaderSize() + 8};
+  for (size_t r = 0; r < rows.size(); r++) {
+    Row row(rows[r]);
+    ASSERT_EQ(sizes[r], row.GetSerializedSize(&fixed_schema));
+    ASSERT_EQ(sizes[r], row.SerializeTo(buf, &fixed_schema));
+    Row decoded;
+    ASSERT_EQ(sizes[r], decoded.DeserializeFrom(buf, &fixed_schema));
+    for (size_t i = 0; i < rows[r].size(); i++) {
+      EXPECT_EQ(rows[r][i].IsNull(), decoded.GetField(i)->IsNull());
+      if (!rows[r][i].IsNull()) {
+        EXPECT_EQ(CmpBool::kTrue, decoded.GetField(i)->CompareEquals(rows[r][i]));
+      }
+    }
+  }
+
+  // Scenario: the bytes are the ones every field writes for itself, rows written before read back the same.
+  Row row(rows[0]);
+  row.SerializeTo(buf, &fixed_schema);
+  char expected[PAGE_SIZE];
+  uint32_t offset = fixed_schema.GetRowHeaderSize();
+  for (auto &field : rows[0]) {
+    offset += field.SerializeTo(expected + offset);
+  }
+  EXPECT_EQ(0, memcmp(buf + fixed_schema.GetRowHeaderSize(), expected + fixed_schema.GetRowHeaderSize(),
+                      offset - fixed_schema.GetRowHeaderSize()));
+
+  std::vector<Column *> char_columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                        new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema char_schema(char_columns);
+  EXPECT_FALSE(char_schema.GetCodec().IsFixedWidth());
+  std::vector<Field> char_fields = {Field(TypeId::kTypeInt, 1),
+                                    Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, false)};
+  Row char_row(char_fields);
+  uint32_t size = char_row.SerializeTo(buf, &char_schema);
+  EXPECT_EQ(char_schema.GetRowHeaderSize() + 4 + 4 + 7, size);
+  Row char_decoded;
+  ASSERT_EQ(size, char_decoded.DeserializeFrom(buf, &char_schema));
+  EXPECT_EQ(CmpBool::kTrue, char_decoded.GetField(1)->CompareEquals(char_fields[1]));
+}
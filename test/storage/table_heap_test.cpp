@@ -1,5 +1,6 @@
 #include "storage/table_heap.h"
 
+#include <set>
 #include <unordered_map>
 #include <vector>
 
@@ -113,8 +114,269 @@ TEST(TableHeapTest, TableHeapSampleTest) {
     ASSERT_EQ(true, bpm->IsPageFree(page_id));
     // cout << bpm->IsPageFree(page_id) << endl;
   }
-  delete disk;
+  // the buffer pools write their dirty pages back on destruction, delete them before their disk managers
   delete bpm;
-  delete disk_mgr_;
+  delete disk;
   delete bpm_;
-}
\ No newline at end of file
+  delete disk_mgr_;
+}
+TEST(TableHeapTest, ReadAheadScanTest) {
+  const std::string db_name = "table_heap_read_ahead_test.db";
+  const int row_nums = 10000;
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  page_id_t first_page_id;
+  {
+    BufferPoolManager bpm(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+    TableHeap *table_heap = TableHeap::Create(&bpm, &schema, nullptr, nullptr, nullptr);
+    for (int i = 0; i < row_nums; i++) {
+      Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 60, true)};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+    first_page_id = table_heap->GetFirstPageId();
+    delete table_heap;
+  }
+
+  // Scenario: scans through a small pool see every row whether pages are read ahead or not, through a ring or not.
+  for (int distance : {0, PREFETCH_DISTANCE, 64}) {
+    for (bool use_strategy : {false, true}) {
+      BufferPoolManager bpm(32, disk_mgr);
+      TableHeap *table_heap = TableHeap::Create(&bpm, first_page_id, &schema, nullptr, nullptr);
+      table_heap->SetPrefetchDistance(distance);
+      std::unique_ptr<BufferAccessStrategy> strategy;
+      if (use_strategy) {
+        strategy = std::make_unique<BufferAccessStrategy>(&bpm);
+      }
+      int count = 0;
+      for (auto iter = table_heap->Begin(nullptr, strategy.get()); iter != table_heap->End(); ++iter) {
+        count++;
+      }
+      EXPECT_EQ(row_nums, count);
+      if (distance == 0) {
+        EXPECT_EQ(0, bpm.GetPrefetchCount());
+      }
+      strategy.reset();
+      ASSERT_TRUE(bpm.CheckAllUnpinned());
+      delete table_heap;
+    }
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  const std::string db_name = "table_heap_fsm_test.db";
+  const int row_nums = 5000;
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  auto insert = [&](TableHeap *table_heap, int id) {
+    Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, 60, true)};
+    Row row(fields);
+    EXPECT_TRUE(table_heap->InsertTuple(row, nullptr));
+    return row.GetRowId();
+  };
+  auto table_fetches = [](BufferPoolManager &bpm) {
+    PageTypeStats stats = bpm.GetStats().Total(PageType::kTable);
+    return stats.hits_ + stats.misses_;
+  };
+  page_id_t first_page_id;
+  page_id_t fsm_page_id;
+  std::vector<RowId> row_ids;
+  std::set<page_id_t> pages;
+  {
+    BufferPoolManager bpm(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+    TableHeap *table_heap = TableHeap::Create(&bpm, &schema, nullptr, nullptr, nullptr);
+    for (int i = 0; i < row_nums; i++) {
+      row_ids.push_back(insert(table_heap, i));
+      pages.insert(row_ids.back().GetPageId());
+    }
+    // Scenario: an insert into a large table touches the page it goes to and the map, not the whole chain.
+    size_t fetches = table_fetches(bpm);
+    insert(table_heap, row_nums);
+    EXPECT_LE(table_fetches(bpm) - fetches, 3);
+
+    // Scenario: the space of deleted rows is offered to the next inserts, the table does not grow.
+    for (int i = 0; i < row_nums / 2; i++) {
+      ASSERT_TRUE(table_heap->MarkDelete(row_ids[i], nullptr));
+      table_heap->ApplyDelete(row_ids[i], nullptr);
+    }
+    for (int i = 0; i < row_nums / 2; i++) {
+      EXPECT_EQ(1, pages.count(insert(table_heap, i).GetPageId()));
+    }
+    first_page_id = table_heap->GetFirstPageId();
+    fsm_page_id = table_heap->GetFreeSpaceMapPageId();
+    ASSERT_TRUE(bpm.CheckAllUnpinned());
+    delete table_heap;
+  }
+
+  // Scenario: the map is read back with the table, the freed rows of the first page are reused after a reopen.
+  {
+    BufferPoolManager bpm(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+    TableHeap *table_heap = TableHeap::Create(&bpm, first_page_id, &schema, nullptr, nullptr, fsm_page_id);
+    EXPECT_EQ(fsm_page_id, table_heap->GetFreeSpaceMapPageId());
+    RowId rid = row_ids.back();
+    ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+    table_heap->ApplyDelete(rid, nullptr);
+    EXPECT_EQ(rid.GetPageId(), insert(table_heap, 0).GetPageId());
+    int count = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      count++;
+    }
+    EXPECT_EQ(row_nums + 1, count);
+    ASSERT_TRUE(bpm.CheckAllUnpinned());
+    delete table_heap;
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, BulkInsertTest) {
+  const std::string db_name = "table_heap_bulk_test.db";
+  const int row_nums = 5000;
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  auto make_row = [&](int id) {
+    Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, 60, true)};
+    return Row(fields);
+  };
+  {
+    BufferPoolManager bpm(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+    TableHeap *table_heap = TableHeap::Create(&bpm, &schema, nullptr, nullptr, nullptr);
+    Row first = make_row(-1);
+    ASSERT_TRUE(table_heap->InsertTuple(first, nullptr));
+    std::vector<Row> rows;
+    for (int i = 0; i < row_nums; i++) {
+      rows.push_back(make_row(i));
+    }
+
+    // Scenario: the rows fill the last page first, then go to pages chained in order, each page is pinned once and
+    // its free space filed once in the map.
+    PageTypeStats before = bpm.GetStats().Total(PageType::kTable);
+    ASSERT_EQ(row_nums, table_heap->BulkInsert(rows, nullptr));
+    PageTypeStats after = bpm.GetStats().Total(PageType::kTable);
+    EXPECT_EQ(first.GetRowId().GetPageId(), rows.front().GetRowId().GetPageId());
+    std::set<page_id_t> pages;
+    for (int i = 0; i < row_nums; i++) {
+      pages.insert(rows[i].GetRowId().GetPageId());
+      if (i > 0) {
+        EXPECT_LE(rows[i - 1].GetRowId().GetPageId(), rows[i].GetRowId().GetPageId());
+      }
+    }
+    EXPECT_LE(after.hits_ + after.misses_ - before.hits_ - before.misses_, 2 * pages.size() + 2);
+
+    // Scenario: every row reads back from the rid it was given, in insert order.
+    int id = -1;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      EXPECT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+      id++;
+    }
+    EXPECT_EQ(row_nums, id);
+    Row row(rows[row_nums / 2].GetRowId());
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    EXPECT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, row_nums / 2)));
+
+    // Scenario: the free-space map knows the new pages, a single insert goes to the last one.
+    Row last = make_row(row_nums);
+    ASSERT_TRUE(table_heap->InsertTuple(last, nullptr));
+    EXPECT_EQ(rows.back().GetRowId().GetPageId(), last.GetRowId().GetPageId());
+
+    ASSERT_TRUE(bpm.CheckAllUnpinned());
+    delete table_heap;
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(TableHeapTest, IteratorTest) {
+  const std::string db_name = "table_heap_iterator_test.db";
+  const int row_nums = 2000;
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  {
+    BufferPoolManager bpm(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+    TableHeap *table_heap = TableHeap::Create(&bpm, &schema, nullptr, nullptr, nullptr);
+    std::vector<RowId> row_ids;
+    std::set<page_id_t> pages;
+    for (int i = 0; i < row_nums; i++) {
+      Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 60, true)};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      row_ids.push_back(row.GetRowId());
+      pages.insert(row.GetRowId().GetPageId());
+    }
+    auto table_fetches = [&bpm]() {
+      PageTypeStats stats = bpm.GetStats().Total(PageType::kTable);
+      return stats.hits_ + stats.misses_;
+    };
+
+    // Scenario: a scan pins each page once however often the rows are looked at.
+    size_t fetches = table_fetches();
+    int id = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      EXPECT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id)));
+      EXPECT_EQ(row_ids[id].Get(), (*iter).GetRowId().Get());
+      id++;
+    }
+    EXPECT_EQ(row_nums, id);
+    EXPECT_EQ(pages.size(), table_fetches() - fetches);
+
+    // Scenario: deleted rows are skipped, also when they leave the first page empty.
+    page_id_t first_page_id = table_heap->GetFirstPageId();
+    int deleted = 0;
+    for (int i = 0; i < row_nums; i++) {
+      if (row_ids[i].GetPageId() == first_page_id || i % 3 == 0) {
+        ASSERT_TRUE(table_heap->MarkDelete(row_ids[i], nullptr));
+        table_heap->ApplyDelete(row_ids[i], nullptr);
+        deleted++;
+      }
+    }
+    int count = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      EXPECT_NE(first_page_id, iter->GetRowId().GetPageId());
+      count++;
+    }
+    EXPECT_EQ(row_nums - deleted, count);
+
+    // Scenario: an iterator left half way, its copies and the iterators moved from all let go of their pages.
+    {
+      auto iter = table_heap->Begin(nullptr);
+      for (int i = 0; i < row_nums / 2; i++) {
+        ++iter;
+      }
+      TableIterator copy(iter);
+      EXPECT_TRUE(copy == iter);
+      auto moved = std::move(copy);
+      iter = std::move(moved);
+      EXPECT_FALSE(bpm.CheckAllUnpinned());
+    }
+    ASSERT_TRUE(bpm.CheckAllUnpinned());
+    delete table_heap;
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}